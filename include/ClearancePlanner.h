@@ -0,0 +1,76 @@
+/**
+ * @file ClearancePlanner.h
+ * @brief 旧款清仓降价规划 - 动态规划求多期最优降价路径
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#ifndef CLEARANCE_PLANNER_H
+#define CLEARANCE_PLANNER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief 规划参数
+ */
+struct ClearanceConfig {
+    // 可选降价档位（相对基础价的折扣），只能逐步加深不能回调；最深 50% 与 clampPrice 下限一致
+    std::vector<double> markdownLevels = {0.0, 0.05, 0.10, 0.15, 0.20, 0.30, 0.40, 0.50};
+    double salvageRate = 0.3;        // 停售后剩余库存按基础价的该比例处理
+    double holdingCostPerDay = 0.0;  // 每件每天的持有成本
+    int maxStockStates = 1000;       // 库存格点上限，库存更大时按批量分桶
+};
+
+/**
+ * @brief 单个 SKU 的清仓问题
+ */
+struct ClearanceProblem {
+    double basePrice = 0.0;
+    int stock = 0;
+    std::vector<double> dailyDemand;  // 距停售前每天在基础价下的预测需求（长度即剩余天数）
+    double elasticity = -1.2;         // 需求 = dailyDemand × (price / basePrice)^elasticity
+};
+
+/**
+ * @brief 清仓计划
+ */
+struct ClearancePlan {
+    std::vector<double> markdown;   // 每天的折扣（0.2 表示打八折）
+    double expectedRevenue = 0.0;   // 销售收入 + 残值 - 持有成本
+    double expectedSold = 0.0;      // 按计划折扣预计售出的件数
+    double expectedLeftover = 0.0;  // 停售时预计剩余件数
+
+    /**
+     * @brief 今天的折扣（无计划时为 0）
+     */
+    double today() const { return markdown.empty() ? 0.0 : markdown.front(); }
+};
+
+/**
+ * @brief 清仓规划器
+ *
+ * 状态为 (天, 剩余库存, 当前折扣档)，动作是保持或加深折扣。期望销量保留小数，
+ * 值表只存在库存格点上，格点之间线性插值，低需求的 SKU 不会因取整而多卖或卖不动。
+ * 值表按线程复用，以代号标记有效格子，规划下一个 SKU 时不需要清空；
+ * 自顶向下只计算用到的格点。
+ */
+class ClearancePlanner {
+public:
+    explicit ClearancePlanner(const ClearanceConfig& config = {});
+
+    ClearancePlan plan(const ClearanceProblem& problem) const;
+
+    /**
+     * @brief 多 SKU 并行规划
+     * @param numThreads 线程数，0 表示使用硬件并发数
+     */
+    std::vector<ClearancePlan> planBatch(const std::vector<ClearanceProblem>& problems,
+                                         unsigned numThreads = 0) const;
+
+private:
+    ClearanceConfig config;
+};
+
+#endif // CLEARANCE_PLANNER_H
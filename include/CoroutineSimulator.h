@@ -0,0 +1,122 @@
+/**
+ * @file CoroutineSimulator.h
+ * @brief C++20 协程事件循环 - 用少量线程驱动大量模拟商家
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#ifndef COROUTINE_SIMULATOR_H
+#define COROUTINE_SIMULATOR_H
+
+#ifdef ENABLE_COROUTINE_SIM
+
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <exception>
+#include <queue>
+#include <vector>
+
+/**
+ * @brief 模拟商家协程的返回类型
+ * 创建后挂起，由 SimEventLoop::spawn() 接管并负责销毁
+ */
+class SimTask {
+public:
+    struct promise_type {
+        SimTask get_return_object() {
+            return SimTask(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept;
+    };
+
+    SimTask(SimTask&& other) noexcept : handle(other.handle) { other.handle = nullptr; }
+    SimTask& operator=(SimTask&&) = delete;
+    SimTask(const SimTask&) = delete;
+    ~SimTask() {
+        if (handle) {
+            handle.destroy();
+        }
+    }
+
+    std::coroutine_handle<> release() {
+        std::coroutine_handle<> h = handle;
+        handle = nullptr;
+        return h;
+    }
+
+private:
+    explicit SimTask(std::coroutine_handle<promise_type> h) : handle(h) {}
+    std::coroutine_handle<promise_type> handle;
+};
+
+/**
+ * @brief 单线程事件循环
+ *
+ * 协程通过 co_await loop.sleepFor(...) 模拟网络延迟，挂起期间不占用线程；
+ * 循环按唤醒时间维护最小堆，只在没有就绪协程时整体等待到最早的唤醒点。
+ * 一个循环只在一个线程上 run()，spawn() 需在 run() 之前调用。
+ */
+class SimEventLoop {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct SleepAwaiter {
+        SimEventLoop& loop;
+        Clock::duration delay;
+
+        bool await_ready() const noexcept { return delay <= Clock::duration::zero(); }
+        void await_suspend(std::coroutine_handle<> h) { loop.wakeAt(Clock::now() + delay, h); }
+        void await_resume() const noexcept {}
+    };
+
+    SimEventLoop() = default;
+    ~SimEventLoop();
+
+    SimEventLoop(const SimEventLoop&) = delete;
+    SimEventLoop& operator=(const SimEventLoop&) = delete;
+
+    /**
+     * @brief 模拟异步 I/O 延迟
+     */
+    SleepAwaiter sleepFor(std::chrono::milliseconds delay) { return SleepAwaiter{*this, delay}; }
+
+    /**
+     * @brief 接管协程并加入就绪队列
+     */
+    void spawn(SimTask task);
+
+    /**
+     * @brief 运行直到所有协程完成
+     */
+    void run();
+
+    size_t completedCount() const { return completed; }
+
+private:
+    struct Timer {
+        Clock::time_point when;
+        uint64_t seq;  // 同一时刻按入队顺序唤醒
+        std::coroutine_handle<> handle;
+
+        bool operator>(const Timer& other) const {
+            return when != other.when ? when > other.when : seq > other.seq;
+        }
+    };
+
+    std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers;
+    std::vector<std::coroutine_handle<>> ready;
+    uint64_t nextSeq = 0;
+    size_t live = 0;
+    size_t completed = 0;
+
+    void wakeAt(Clock::time_point when, std::coroutine_handle<> h);
+    void resume(std::coroutine_handle<> h);
+};
+
+#endif // ENABLE_COROUTINE_SIM
+
+#endif // COROUTINE_SIMULATOR_H
@@ -0,0 +1,120 @@
+/**
+ * @file DailyHistory.h
+ * @brief 按日历天对齐的稠密销售历史 - 全局纪元 + 天偏移，缺失天显式补齐
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#ifndef DAILY_HISTORY_H
+#define DAILY_HISTORY_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "DataLoader.h"
+#include "SalesColumns.h"
+
+/**
+ * @brief 单个产品的稠密日序列
+ *
+ * 天数均为自 1970-01-01 起的天数（与 parseCivilDate 一致），按 day - firstDay()
+ * 直接下标访问。没有记录的天销量为 0、observed 为 false，价格与库存沿用前一个观测值。
+ *
+ * compress() 把逐日数组换成 SalesColumns 常驻，只保留区间与观测位图；压缩后逐日访问
+ * 需先 expand() 取回稠密副本，预测可直接扫描 columns()。
+ */
+class DailySeries {
+public:
+    /**
+     * @brief 记录一天的数据；同一天出现多次时销量累加，价格与库存取最后一条
+     * 已压缩的序列先解压再记录。
+     */
+    void record(int64_t day, double sales, double price, int stock);
+
+    bool empty() const;
+    int64_t firstDay() const;
+    int64_t lastDay() const;
+    size_t length() const;       // lastDay - firstDay + 1
+    size_t missingDays() const;  // 区间内没有记录的天数
+
+    bool observed(int64_t day) const;
+    double sales(int64_t day) const;  // 区间外或缺失天为 0
+    double price(int64_t day) const;  // 区间外返回 0
+    int stock(int64_t day) const;     // 区间外返回 0
+
+    /**
+     * @brief 从 firstDay 到 lastDay 的逐日销量（缺失天为 0），可直接交给 Forecaster
+     */
+    const std::vector<double>& dailySales() const;
+
+    /**
+     * @brief 压缩为 SalesColumns 并释放逐日数组
+     */
+    void compress();
+    bool compressed() const;
+    const SalesColumns& columns() const;  // 仅压缩后有效
+
+    /**
+     * @brief 稠密副本（未压缩时直接复制）
+     */
+    DailySeries expand() const;
+
+private:
+    int64_t start = 0;
+    std::vector<double> salesByDay;
+    std::vector<double> priceByDay;
+    std::vector<int> stockByDay;
+    std::vector<uint8_t> observedByDay;
+    size_t observedCount = 0;
+
+    SalesColumns packed;
+    std::vector<bool> observedBits;  // 压缩后的观测标记
+    bool isCompressed = false;
+
+    size_t days() const;
+    bool inRange(int64_t day) const;
+    void fillForward(size_t from);
+};
+
+/**
+ * @brief 全部产品的日序列，共享同一纪元（最早的销售日期）
+ */
+class DailyHistory {
+public:
+    /**
+     * @brief 由销售记录构建；日期无法解析的行被跳过
+     * @return 成功导入的行数
+     */
+    size_t build(const std::vector<Sale>& rows);
+
+    int64_t epochDay() const;  // 所有产品中最早的一天
+    int64_t lastDay() const;   // 所有产品中最晚的一天
+
+    /**
+     * @brief 某天相对纪元的偏移（不同产品的同一天偏移相同）
+     */
+    int64_t offset(int64_t day) const;
+
+    const DailySeries* find(const std::string& productId) const;
+    const std::map<std::string, DailySeries>& products() const;
+
+    /**
+     * @brief 压缩全部产品的日序列
+     */
+    void compress();
+
+    /**
+     * @brief 天数 -> "YYYY-MM-DD"
+     */
+    static std::string formatDay(int64_t day);
+
+private:
+    std::map<std::string, DailySeries> series;  // 按产品 ID 有序，遍历顺序稳定
+    int64_t epoch = 0;
+    int64_t latest = 0;
+    bool hasDays = false;
+};
+
+#endif // DAILY_HISTORY_H
@@ -1,8 +1,11 @@
 #ifndef DATALOADER_H
 #define DATALOADER_H
 
+#include <functional>
+#include <set>
 #include <vector>
 #include <string>
+#include <string_view>
 
 struct Sale {
     std::string date;
@@ -10,18 +13,58 @@ struct Sale {
     int sales;
     double price;
     int stock;
+    bool flagged = false;  // 被异常过滤器标记
 };
 
+// 导入过滤条件：扫描时先比较日期与产品 ID，不匹配的行不解析、不分配
+struct LoadFilter {
+    std::set<std::string, std::less<>> products;  // 空表示不限产品
+    std::string fromDate;                          // "YYYY-MM-DD"，含当天；空表示不限
+    std::string toDate;                            // "YYYY-MM-DD"，含当天；空表示不限
+
+    bool empty() const;
+    bool matches(std::string_view date, std::string_view productId) const;
+};
+
+class SalesAnomalyFilter;
+
 class DataLoader {
 public:
     DataLoader(const std::string& filename);
+    // 设置后导入时逐行经过异常过滤（过滤器由调用方持有）
+    void setAnomalyFilter(SalesAnomalyFilter* filter);
     bool loadData();
+    // 只导入匹配的行；存在与数据文件一致的稀疏索引时直接跳到相关的块
+    bool loadData(const LoadFilter& filter);
     const std::vector<Sale>& getSalesData() const;
+    // 取走已载入的数据（之后 getSalesData 为空）
+    std::vector<Sale> releaseSalesData();
     void displayData() const;
 
+    // 在数据文件旁写稀疏偏移索引（<filename>.idx）：每 blockRows 行记录一次偏移与日期范围，
+    // 并为每个产品记录出现过的块区间
+    static bool buildIndex(const std::string& filename, size_t blockRows = 4096);
+    // 索引存在且与数据文件的大小和修改时间一致（旧格式索引视为过期）
+    static bool indexIsCurrent(const std::string& filename);
+
 private:
+    struct IndexBlock {
+        long long offset = 0;
+        size_t rows = 0;
+        std::string minDate;
+        std::string maxDate;
+    };
+
     std::string filename;
     std::vector<Sale> salesData;
+    SalesAnomalyFilter* anomalyFilter = nullptr;
+
+    static std::string indexPath(const std::string& filename);
+    // 读取索引并选出可能包含匹配行的块（按文件顺序）；索引不可用时返回 false
+    static bool selectBlocks(const std::string& filename, const LoadFilter& filter,
+                             std::vector<IndexBlock>& selected, size_t& totalBlocks);
+    static bool parseLine(const std::string& line, const LoadFilter& filter, Sale& sale,
+                          bool& malformed);
 };
 
 #endif
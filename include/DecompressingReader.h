@@ -0,0 +1,96 @@
+/**
+ * @file DecompressingReader.h
+ * @brief 压缩销售文件的流式读取 - 按魔数识别 gzip / zstd，后台线程解压，双缓冲交给解析线程
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#ifndef DECOMPRESSING_READER_H
+#define DECOMPRESSING_READER_H
+
+#include <condition_variable>
+#include <cstddef>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief 文件压缩格式
+ */
+enum class CompressionFormat {
+    NONE,
+    GZIP,  // 1f 8b
+    ZSTD   // 28 b5 2f fd
+};
+
+/**
+ * @brief 按行读取（可能压缩的）文本文件
+ *
+ * 压缩文件由后台线程分块读取并解压到两个缓冲区之一，解析线程读取另一个，
+ * 解压与解析重叠进行，不需要先把解压结果落盘。gzip 需要编译时找到 zlib，
+ * zstd 需要找到 libzstd（见 CMakeLists.txt），缺失时 open() 报错返回 false。
+ */
+class DecompressingReader {
+public:
+    DecompressingReader() = default;
+    ~DecompressingReader();
+
+    DecompressingReader(const DecompressingReader&) = delete;
+    DecompressingReader& operator=(const DecompressingReader&) = delete;
+
+    /**
+     * @brief 根据文件开头的魔数识别格式
+     */
+    static CompressionFormat detect(const std::string& filename);
+
+    /**
+     * @brief 打开文件；压缩文件会启动解压线程
+     */
+    bool open(const std::string& filename);
+
+    /**
+     * @brief 读取下一行（不含换行符），读完或解压出错时返回 false
+     */
+    bool getline(std::string& line);
+
+    /**
+     * @brief 解压过程中是否出错（数据损坏或被截断）
+     */
+    bool failed() const;
+
+    CompressionFormat format() const;
+
+private:
+    static constexpr size_t kBufferSize = 1 << 20;
+
+    struct Buffer {
+        std::vector<char> data;
+        size_t size = 0;
+        bool ready = false;  // 已填满、等待解析线程取走
+    };
+
+    CompressionFormat fileFormat = CompressionFormat::NONE;
+    std::ifstream plain;  // 未压缩文件直接按行读
+
+    Buffer buffers[2];
+    mutable std::mutex mutex;
+    std::condition_variable cv;
+    bool finished = false;  // 解压线程已写完最后一个缓冲区
+    bool error = false;
+    bool stopping = false;
+    std::thread worker;
+
+    // 解析线程的读取位置
+    int current = -1;
+    size_t position = 0;
+    int nextBuffer = 0;
+
+    void decompressLoop(std::string filename);
+    bool publish(int index, size_t size);  // 交出缓冲区并等待下一个空闲缓冲区
+    bool acquire();                        // 解析线程取下一个已填满的缓冲区
+    void close();
+};
+
+#endif // DECOMPRESSING_READER_H
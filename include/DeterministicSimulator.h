@@ -0,0 +1,106 @@
+/**
+ * @file DeterministicSimulator.h
+ * @brief 确定性并行定价模拟 - 逻辑时钟 + 按序提交 + 可回放事件日志
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#ifndef DETERMINISTIC_SIMULATOR_H
+#define DETERMINISTIC_SIMULATOR_H
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <vector>
+
+#include "ThreadManager.h"  // Merchant, ThreadSafePriceTable, ProductCatalog
+
+namespace pricing {
+    class PricingStrategy;
+}
+
+/**
+ * @brief 确定性模拟配置
+ */
+struct DeterministicConfig {
+    uint64_t seed = 42;
+    int ticks = 24;
+    int numThreads = 0;        // 0 表示使用硬件并发数
+    int tickMinutes = 60;      // 每个逻辑 tick 对应的模拟分钟数
+    int startYear = 2025;      // 逻辑时钟起点（不读取系统时间）
+    int startMonth = 11;
+    int startDay = 11;
+};
+
+/**
+ * @brief 确定性定价模拟器
+ *
+ * 与 ThreadManager 的商家线程模式使用相同的定价输入（新型号上市同样查询目录的系列谱系，
+ * 按逻辑日期判断），但：
+ * - 所有随机数由 (seed, tick, 任务序号) 派生，不使用 random_device / rand()
+ * - 时间来自逻辑时钟，不读取系统时间
+ * - 每个 tick 内各任务只读取上一 tick 已提交的价格，并行计算后
+ *   按 (商家, 产品) 固定顺序提交，结果与线程数和调度无关
+ *
+ * 运行时写出二进制事件日志，replay() 可逐位重建价格表。
+ *
+ * 日志格式（小端，varint 为 LEB128）：
+ *   "DPEL" | u32 版本 | u64 seed | 产品表 | 商家表 | 初始价格 (f64 × 产品数)
+ *   每个 tick: varint(事件数 + 1) 后跟事件 [varint 商家, varint 产品, f64 新价格]
+ *   结束: varint(0) | u64 最终价格表校验和
+ */
+class DeterministicSimulator {
+public:
+    /**
+     * @param catalog 产品元数据（类别、系列、新品）在构造时按句柄取出并缓存；
+     *                系列谱系在运行时按句柄查询，目录须比模拟器活得久
+     */
+    DeterministicSimulator(const std::vector<Merchant>& merchants,
+                           pricing::PricingStrategy& strategy,
+                           ProductCatalog& catalog,
+                           const DeterministicConfig& config = DeterministicConfig());
+
+    /**
+     * @brief 运行模拟，按序提交到 table 并写出事件日志
+     * @return 最终价格表校验和
+     */
+    uint64_t run(ThreadSafePriceTable& table, const std::string& eventLogPath);
+
+    /**
+     * @brief 从事件日志回放到 table
+     * @param maxTick 只回放 tick < maxTick 的事件（用于定位异常）
+     * @param checksum 输出回放后的校验和
+     * @return 日志完整且（完整回放时）校验和一致返回 true
+     */
+    static bool replay(const std::string& eventLogPath, ThreadSafePriceTable& table,
+                       uint32_t maxTick = UINT32_MAX, uint64_t* checksum = nullptr);
+
+    /**
+     * @brief 逻辑时钟：第 tick 个时间片对应的模拟时间
+     */
+    std::tm logicalTime(int tick) const;
+
+private:
+    struct TaskSlot {
+        uint32_t merchant;
+        uint32_t product;
+    };
+
+    const std::vector<Merchant>& merchants;
+    pricing::PricingStrategy& strategy;
+    const ProductCatalog& catalog;
+    DeterministicConfig config;
+
+    std::vector<std::string> productIds;
+    std::vector<ProductInfo> productInfo;  // 按产品序号，来自目录
+    std::vector<uint32_t> productHandles;  // 按产品序号，目录句柄
+    std::vector<TaskSlot> tasks;          // 提交顺序：商家序号，其次上架顺序
+    std::vector<double> committed;        // 已提交价格（按产品序号）
+    std::vector<double> proposed;         // 本 tick 计算结果（按任务序号）
+
+    int64_t logicalDay(int tick) const;  // 自 1970-01-01 起的天数
+    double computeTask(size_t taskIndex, int tick) const;
+    static uint64_t checksumOf(const std::vector<double>& prices);
+};
+
+#endif // DETERMINISTIC_SIMULATOR_H
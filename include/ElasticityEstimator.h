@@ -0,0 +1,107 @@
+/**
+ * @file ElasticityEstimator.h
+ * @brief 价格弹性估计 - 按 SKU / 类别拟合 log-log 弹性，SKU 估计向类别收缩
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#ifndef ELASTICITY_ESTIMATOR_H
+#define ELASTICITY_ESTIMATOR_H
+
+#include <array>
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+#include "DataLoader.h"
+#include "ProductCatalog.h"
+
+/**
+ * @brief 估计参数
+ */
+struct ElasticityConfig {
+    double priorElasticity = -1.2;  // 类别数据不足时的先验
+    double shrinkage = 0.05;        // 收缩强度（以 log 价格离差平方和计）
+};
+
+/**
+ * @brief 一个产品的弹性估计
+ */
+struct ElasticityEstimate {
+    double elasticity = 0.0;          // 收缩后的最终估计（定价使用）
+    double skuElasticity = 0.0;       // 仅用本 SKU 数据的斜率（价格无变化时为 NaN）
+    double categoryElasticity = 0.0;  // 所属类别的合并估计
+    double skuWeight = 0.0;           // 本 SKU 数据所占权重 [0, 1)
+    uint64_t observations = 0;
+};
+
+/**
+ * @brief 价格弹性估计器
+ *
+ * 对每个 SKU 维护 x = ln(price)、y = ln(sales) 的均值与离差积（可合并的充分统计量），
+ * 新数据到达时只累加新行，不需要重新扫描历史。类别估计为组内（固定效应）合并斜率：
+ *   β_c = (ΣCxy + κ·prior) / (ΣCxx + κ)
+ * SKU 估计向类别收缩：
+ *   β_s = (Cxy_s + κ·β_c) / (Cxx_s + κ)
+ * 价格几乎不变的 SKU 自然退化为类别值。查询 O(1)。
+ */
+class ElasticityEstimator {
+public:
+    explicit ElasticityEstimator(ProductCatalog& catalog, const ElasticityConfig& config = {});
+
+    /**
+     * @brief 增量导入销售记录（按固定 kIngestBlockRows 行分块并行累加，再按块顺序合并）
+     * @param numThreads 线程数，0 表示使用硬件并发数
+     * @return 参与拟合的行数（销量或价格非正、被异常过滤器标记的行被跳过）
+     */
+    size_t ingest(const std::vector<Sale>& rows, unsigned numThreads = 0);
+
+    /**
+     * @brief 按目录句柄查询
+     */
+    ElasticityEstimate estimate(uint32_t handle) const;
+
+    /**
+     * @brief 按产品 ID 查询（目录外的产品按其推断类别返回类别估计）
+     */
+    ElasticityEstimate estimate(const std::string& productId) const;
+
+    /**
+     * @brief 类别估计
+     */
+    double categoryElasticity(ProductCategory category) const;
+
+private:
+    static constexpr size_t kIngestBlockRows = 16384;
+
+    struct Moments {
+        uint64_t n = 0;
+        double meanX = 0.0;
+        double meanY = 0.0;
+        double cxx = 0.0;  // Σ(x - x̄)²
+        double cxy = 0.0;  // Σ(x - x̄)(y - ȳ)
+
+        void add(double x, double y);
+        void merge(const Moments& other);
+    };
+
+    struct CategorySums {
+        double cxx = 0.0;
+        double cxy = 0.0;
+        uint64_t n = 0;
+    };
+
+    ProductCatalog& catalog;
+    ElasticityConfig config;
+
+    mutable std::shared_mutex mutex;
+    std::vector<Moments> skus;                 // 按目录句柄索引
+    std::vector<uint8_t> skuCategory;          // 句柄 -> 类别（缓存，避免查询时再访问目录）
+    std::array<CategorySums, 5> categories{};  // 按 ProductCategory 索引
+
+    double categorySlopeLocked(size_t category) const;
+    ElasticityEstimate estimateLocked(const Moments& m, size_t category) const;
+};
+
+#endif // ELASTICITY_ESTIMATOR_H
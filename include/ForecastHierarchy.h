@@ -0,0 +1,104 @@
+/**
+ * @file ForecastHierarchy.h
+ * @brief 层级需求预测 - SKU → 系列 → 类别的自底向上汇总与协调
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#ifndef FORECAST_HIERARCHY_H
+#define FORECAST_HIERARCHY_H
+
+#include <array>
+#include <cstdint>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "DailyHistory.h"
+#include "Forecaster.h"
+#include "ProductCatalog.h"
+
+/**
+ * @brief 层级中一个节点（SKU / 系列 / 类别）的日需求预测
+ */
+struct NodeForecast {
+    double dailyDemand = 0.0;    // 下属 SKU 移动平均水平之和
+    double noiseVariance = 0.0;  // 逐日需求方差之和（SKU 间视为独立）
+    double levelVariance = 0.0;  // 水平估计误差方差之和
+    size_t skuCount = 0;
+
+    /**
+     * @brief 展开为多步预测与提前期累计需求（口径同 Forecaster::forecastHorizon）
+     */
+    HorizonForecast expand(int horizon, int leadTimeDays, double z = 1.645) const;
+};
+
+/**
+ * @brief 层级预测
+ *
+ * 每个 SKU 维护移动平均窗口和与一步残差平方和，新销量到达时 O(1) 更新；
+ * 系列与类别节点保存下属 SKU 的水平与方差之和，只按变动 SKU 的差量调整，
+ * 因此类别级查询是 O(1) 读取，不需要重新汇总所有 SKU。
+ * 上层预测由 SKU 预测求和得到，各层天然一致（自底向上协调）；
+ * 类别级采购量可按 SKU 预测占比下分（allocate）。
+ */
+class ForecastHierarchy {
+public:
+    explicit ForecastHierarchy(ProductCatalog& catalog, int window = 3);
+
+    /**
+     * @brief 导入按日历天补齐的日序列（缺失天销量为 0），与逐 SKU 预测使用同一输入
+     * 多线程更新 SKU 状态，各线程先在本地累加节点差量再合并。同一产品分多次导入时
+     * 依次追加，两次之间的缺失天不补齐。
+     * @param numThreads 线程数，0 表示使用硬件并发数
+     * @return 导入的天数
+     */
+    size_t ingest(const DailyHistory& history, unsigned numThreads = 0);
+
+    /**
+     * @brief 追加一个 SKU 的一天销量
+     */
+    void addSale(uint32_t handle, double units);
+
+    NodeForecast sku(uint32_t handle) const;
+    NodeForecast series(const std::string& seriesName) const;
+    NodeForecast category(ProductCategory category) const;
+
+    /**
+     * @brief 把类别级数量按 SKU 预测占比分到各 SKU（总预测为 0 时平均分配）
+     */
+    std::vector<std::pair<uint32_t, double>> allocate(ProductCategory category,
+                                                      double quantity) const;
+
+private:
+    struct SkuState {
+        std::vector<double> ring;  // 最近 window 天销量
+        double windowSum = 0.0;
+        double residualSq = 0.0;
+        uint64_t residualCount = 0;
+        uint64_t n = 0;
+        uint32_t series = 0;
+        uint8_t category = 0;
+        bool known = false;
+
+        void add(double units, size_t window);
+        NodeForecast forecast(size_t window) const;
+    };
+
+    ProductCatalog& catalog;
+    size_t window;
+
+    mutable std::shared_mutex mutex;
+    std::vector<SkuState> skus;  // 按目录句柄索引
+    std::unordered_map<std::string, uint32_t> seriesIds;
+    std::vector<NodeForecast> seriesNodes;
+    std::array<NodeForecast, 5> categoryNodes{};  // 按 ProductCategory 索引
+    std::array<std::vector<uint32_t>, 5> categoryMembers;
+
+    SkuState& stateLocked(uint32_t handle);
+    static void accumulate(NodeForecast& node, const NodeForecast& delta, double sign);
+};
+
+#endif // FORECAST_HIERARCHY_H
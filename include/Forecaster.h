@@ -2,11 +2,34 @@
 #define FORECASTER_H
 
 #include <vector>
+#include <string>
+
+#include "SalesColumns.h"
+
+// 1..H 步预测及提前期累计需求（含预测区间）
+struct HorizonForecast {
+    std::vector<double> mean;   // 第 h 步的点预测（h = 1..H）
+    std::vector<double> lower;  // 第 h 步预测区间下界
+    std::vector<double> upper;  // 第 h 步预测区间上界
+    int leadTimeDays = 0;
+    double leadTimeDemand = 0.0;  // 前 leadTimeDays 步累计需求
+    double leadTimeLower = 0.0;
+    double leadTimeUpper = 0.0;
+};
 
 class Forecaster {
 public:
     static std::vector<double> movingAverage(const std::vector<double>& history, int window);
     static double predictNext(const std::vector<double>& history, int window = 3);
+    // 一次遍历历史得到 1..horizon 步预测与提前期累计需求；z 为区间分位数（1.645 ≈ 90% 双侧）
+    static HorizonForecast forecastHorizon(const std::vector<double>& history, int horizon,
+                                           int leadTimeDays, int window = 3, double z = 1.645);
+    // 同上，直接按块解码压缩销售列
+    static HorizonForecast forecastHorizon(const SalesColumns& columns, int horizon,
+                                           int leadTimeDays, int window = 3, double z = 1.645);
+    // 由水平与方差展开 1..horizon 步预测：noiseVar 为逐日需求方差，levelVar 为水平估计误差方差
+    static HorizonForecast expandLevel(double level, double noiseVar, double levelVar,
+                                       int horizon, int leadTimeDays, double z = 1.645);
     static void displayForecast(const std::vector<double>& history, 
                                const std::vector<double>& forecast, 
                                const std::vector<std::string>& dates);
@@ -0,0 +1,85 @@
+/**
+ * @file HeavyHitters.h
+ * @brief 流式 Top-K - Space-Saving 计数器 + Count-Min 草图，内存固定，随时可查询
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#ifndef HEAVY_HITTERS_H
+#define HEAVY_HITTERS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Count-Min 草图：depth 行 × width 列计数器
+ * estimate() 不低于真实频次，高估量以高概率不超过 total() × e / width。
+ */
+class CountMinSketch {
+public:
+    explicit CountMinSketch(size_t width = 1024, size_t depth = 4);
+
+    void add(const std::string& key, uint64_t weight = 1);
+    uint64_t estimate(const std::string& key) const;
+    uint64_t total() const;
+    void clear();
+
+private:
+    size_t width;
+    size_t depth;
+    std::vector<uint64_t> counters;  // 第 row 行位于 [row * width, (row + 1) * width)
+    uint64_t totalWeight = 0;
+};
+
+/**
+ * @brief 一个被跟踪的键：真实频次在 [count - error, count] 之内
+ */
+struct HeavyHitter {
+    std::string key;
+    uint64_t count = 0;
+    uint64_t error = 0;
+};
+
+/**
+ * @brief Space-Saving 重击者跟踪
+ *
+ * 最多跟踪 capacity 个键，计数器按 count 组成最小堆。未跟踪的新键替换堆顶并继承
+ * 堆顶计数，频次超过 total() / capacity 的键一定在跟踪集合中。所有键同时计入
+ * Count-Min 草图：查询时计数器与草图估计都是频次上界，取较小者收紧高估。
+ * add() 为 O(log capacity)，top(k) 只排序 capacity 个计数器，与键的总数无关。
+ * 非线程安全，由持有者加锁。
+ */
+class HeavyHitters {
+public:
+    explicit HeavyHitters(size_t capacity = 64);
+
+    void add(const std::string& key, uint64_t weight = 1);
+
+    /**
+     * @brief 计数最大的 k 个键（按 count 降序，同计数按键）
+     */
+    std::vector<HeavyHitter> top(size_t k) const;
+
+    /**
+     * @brief 任意键的频次上界：被跟踪时取计数器，否则取堆顶计数与草图估计中较小者
+     */
+    uint64_t estimate(const std::string& key) const;
+
+    uint64_t total() const;
+    size_t capacity() const;
+    void clear();
+
+private:
+    size_t limit;
+    std::vector<HeavyHitter> heap;                   // 按 count 的最小堆
+    std::unordered_map<std::string, size_t> slots;   // 键 -> 在 heap 中的下标
+    CountMinSketch sketch;
+
+    void siftDown(size_t i);
+    void swapSlots(size_t a, size_t b);
+};
+
+#endif // HEAVY_HITTERS_H
@@ -9,6 +9,10 @@
 #include <iomanip>
 #include <sstream>
 
+#include "Forecaster.h"
+#include "HeavyHitters.h"
+#include "ProductCatalog.h"
+
 using namespace std;
 
 /**
@@ -31,14 +35,8 @@ public:
         CRITICAL    // Immediate action required
     };
 
-    // Product categories for electronics
-    enum class ProductCategory {
-        SMARTPHONE,
-        LAPTOP,
-        GPU,
-        TABLET,
-        GENERAL
-    };
+    // Product categories for electronics (shared with pricing via ProductCatalog)
+    using ProductCategory = ::ProductCategory;
 
     // Alert record structure
     struct AlertRecord {
@@ -59,6 +57,7 @@ private:
     vector<AlertRecord> alertHistory;           // All alert records
     map<string, int> productThresholds;         // Custom thresholds per product
     map<string, int> alertCountByProduct;       // Alert frequency tracking
+    HeavyHitters alertLeaders;                  // Most-alerted products (fixed memory)
     mutable mutex alertMutex;                   // Thread-safe operations
     int totalAlerts;                            // Total alert counter
 
@@ -68,6 +67,9 @@ private:
     string categoryToString(ProductCategory category) const;
     double getCategoryMultiplier(ProductCategory category) const;
     bool isPromotionalPeriod() const;
+    bool raiseAlert(const string& productID, const string& productName,
+                    double forecast, int currentStock, AlertLevel level,
+                    ProductCategory category);
 
 public:
     // Constructor
@@ -81,12 +83,20 @@ public:
                    double forecast, int currentStock, 
                    ProductCategory category = ProductCategory::GENERAL);
 
+    // Lead-time alert check: compares stock with cumulative demand over the lead time
+    bool checkAlert(const string& productID, const string& productName,
+                   const HorizonForecast& forecast, int currentStock,
+                   ProductCategory category = ProductCategory::GENERAL);
+
     // Alert level determination
     AlertLevel getAlertLevel(double forecast, int currentStock) const;
     
     // Threshold calculation
     int calculateThreshold(const string& productID, ProductCategory category,
                           int avgDailySales, int leadTimeDays) const;
+
+    // Threshold from the upper bound of forecast lead-time demand
+    int calculateThreshold(ProductCategory category, const HorizonForecast& forecast) const;
     
     void setProductThreshold(const string& productID, int threshold);
     int getProductThreshold(const string& productID) const;
@@ -99,6 +109,8 @@ public:
     // Statistics and reporting
     int getTotalAlerts() const;
     map<string, int> getAlertsByProduct() const;
+    // Products with the most alerts, answered from the streaming tracker without sorting
+    vector<HeavyHitter> getTopAlertProducts(size_t count = 5) const;
     vector<AlertRecord> getCriticalAlerts() const;
     vector<AlertRecord> getAlertsByLevel(AlertLevel level) const;
     vector<AlertRecord> getAllAlerts() const;
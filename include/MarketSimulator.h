@@ -0,0 +1,134 @@
+/**
+ * @file MarketSimulator.h
+ * @brief 多商家竞争市场模拟 - 共享报价簿 + 离散时间并行推进
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#ifndef MARKET_SIMULATOR_H
+#define MARKET_SIMULATOR_H
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ThreadManager.h"  // Merchant, ProductCatalog
+
+namespace pricing {
+    class PricingStrategy;
+}
+
+/**
+ * @brief 按 (商家, 产品) 存储报价的价格簿
+ *
+ * 每个商家的报价存放在自己连续的槽位中（CSR 布局），只由该商家写入；
+ * 每个产品的最低价（连同报价商家）与次低价用原子 CAS 取最小值维护，无需加锁，
+ * 最低价商家看到的对手价是次低价。
+ * 最低价采用双缓冲：一个 tick 内读取上一 tick 的结果，同时累积本 tick 的报价，
+ * publishTick() 时交换，因此商家提价后最低价也能正确回升。
+ */
+class PriceBook {
+public:
+    PriceBook(const std::vector<Merchant>& merchants);
+
+    size_t merchantCount() const { return listingOffsets.size() - 1; }
+    size_t productCount() const { return productIds.size(); }
+
+    /**
+     * @brief 商家 m 的第 j 个上架产品
+     */
+    size_t listingCount(size_t merchant) const;
+    size_t slotIndex(size_t merchant, size_t j) const { return listingOffsets[merchant] + j; }
+    size_t slotCount() const { return listingPrices.size(); }
+    uint32_t listingProduct(size_t merchant, size_t j) const;
+    double getPrice(size_t merchant, size_t j) const;
+
+    /**
+     * @brief 写入报价并计入本 tick 的最低价（只应由该商家所在线程调用）
+     */
+    void postPrice(size_t merchant, size_t j, double price);
+
+    /**
+     * @brief 上一 tick 发布的产品最低价（无报价时为 0）
+     */
+    double bestPrice(uint32_t product) const;
+
+    /**
+     * @brief 上一 tick 除 merchant 自己以外的最低价（没有其他报价时为 0）
+     */
+    double competitorPrice(uint32_t product, size_t merchant) const;
+
+    /**
+     * @brief 结束当前 tick：发布累积的最低价并重置累加器
+     */
+    void publishTick();
+
+    const std::string& productId(uint32_t product) const { return productIds[product]; }
+    std::map<std::string, double> getBestPrices() const;
+
+private:
+    std::vector<std::string> productIds;
+    std::unordered_map<std::string, uint32_t> productIndex;
+    std::vector<size_t> listingOffsets;    // 商家 m 的槽位为 [offsets[m], offsets[m+1])
+    std::vector<uint32_t> listingProducts;
+    std::vector<double> listingPrices;
+
+    // 正的 double 按位比较与数值比较顺序一致，可直接对位模式做原子最小值；
+    // 最低价键的低位存报价商家编号
+    std::unique_ptr<std::atomic<uint64_t>[]> publishedBest;
+    std::unique_ptr<std::atomic<uint64_t>[]> pendingBest;
+    std::unique_ptr<std::atomic<uint64_t>[]> publishedSecond;
+    std::unique_ptr<std::atomic<uint64_t>[]> pendingSecond;
+};
+
+/**
+ * @brief 离散时间竞争市场模拟器
+ *
+ * 每个 tick 内，商家按线程分片并行定价：读取上一 tick 其他商家的最低价作为
+ * MarketContext::competitorPrice，调用 PricingStrategy 得到新价，
+ * 按相对该价格的价差模拟成交并扣减库存。所有线程到达屏障后发布新最低价。
+ */
+class MarketSimulator {
+public:
+    MarketSimulator(const std::vector<Merchant>& merchants,
+                    pricing::PricingStrategy& strategy,
+                    ProductCatalog& catalog,
+                    uint32_t seed = 42);
+
+    /**
+     * @brief 运行指定 tick 数
+     * @param numThreads 工作线程数（0 表示使用硬件并发数）
+     */
+    void run(int ticks, int numThreads = 0);
+
+    const PriceBook& getPriceBook() const { return book; }
+    std::map<std::string, double> getBestPrices() const { return book.getBestPrices(); }
+
+    /**
+     * @brief 导出每个 tick 各产品最低价（price war 走势）
+     */
+    void exportBestPriceTrend(const std::string& filename) const;
+
+private:
+    struct ListingState {
+        double listPrice = 0.0;   // 建议零售价，作为定价基准
+        int stock = 0;
+        double demandEstimate = 0.0;
+    };
+
+    pricing::PricingStrategy& strategy;
+    uint32_t seed;
+    PriceBook book;
+    std::vector<ListingState> listings;  // 与 PriceBook 槽位一一对应
+    std::vector<ProductInfo> productInfo;  // 按 PriceBook 产品序号，来自目录
+    std::vector<std::vector<double>> bestHistory;  // [tick][product]
+    int tickCount = 0;
+
+    void simulateMerchant(size_t merchant, int tick);
+};
+
+#endif // MARKET_SIMULATOR_H
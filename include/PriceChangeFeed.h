@@ -0,0 +1,110 @@
+/**
+ * @file PriceChangeFeed.h
+ * @brief 价格变更订阅流 - 多播环形缓冲 + 独立消费游标
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#ifndef PRICE_CHANGE_FEED_H
+#define PRICE_CHANGE_FEED_H
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief 一条价格变更事件
+ */
+struct PriceChangeEvent {
+    uint64_t sequence = 0;   // 全局递增序号
+    uint32_t product = 0;    // 产品句柄，用 PriceChangeFeed::productName() 解析
+    double oldPrice = 0.0;
+    double newPrice = 0.0;
+    uint64_t version = 0;    // 写入后的条目版本号
+};
+
+/**
+ * @brief 价格变更多播流
+ *
+ * 生产者（价格表写入路径）用 fetch_add 领取序号后写入环形槽位，从不等待消费者；
+ * 每个订阅者持有自己的游标增量读取。消费者落后超过一圈时跳到最旧的
+ * 可用事件并累计丢失数，由调用方决定是否回退到全量 getAllPrices()。
+ * 槽位带版本戳，读取时校验前后一致，避免读到被覆盖一半的数据。
+ */
+class PriceChangeFeed {
+public:
+    class Subscription {
+    public:
+        /**
+         * @brief 读取新事件（追加到 out），返回本次读取条数
+         */
+        size_t poll(std::vector<PriceChangeEvent>& out, size_t maxEvents = SIZE_MAX);
+
+        /**
+         * @brief 因落后被覆盖而丢失的事件数
+         */
+        uint64_t droppedCount() const { return dropped; }
+
+        /**
+         * @brief 当前游标与最新事件之间的距离
+         */
+        uint64_t lag() const;
+
+    private:
+        friend class PriceChangeFeed;
+        Subscription(const PriceChangeFeed& feed, uint64_t start, std::vector<bool> filter);
+
+        const PriceChangeFeed& feed;
+        uint64_t cursor;
+        uint64_t dropped = 0;
+        std::vector<bool> filter;  // 按产品句柄过滤，空表示订阅全部
+    };
+
+    /**
+     * @param capacity 环形缓冲大小（向上取整到 2 的幂）
+     */
+    explicit PriceChangeFeed(size_t capacity = 65536);
+
+    /**
+     * @brief 发布一条变更（多生产者安全，不阻塞）
+     */
+    void publish(uint32_t product, double oldPrice, double newPrice, uint64_t version);
+
+    /**
+     * @brief 产品 ID -> 句柄（首次出现时分配）
+     */
+    uint32_t intern(const std::string& productId);
+    std::string productName(uint32_t handle) const;
+
+    /**
+     * @brief 从当前最新位置开始订阅
+     * @param products 只关心的产品集合，空表示全部
+     */
+    std::unique_ptr<Subscription> subscribe(const std::vector<std::string>& products = {});
+
+    uint64_t publishedCount() const { return head.load(std::memory_order_acquire); }
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> stamp{0};  // 2*seq+1 写入中，2*seq+2 已发布
+        std::atomic<uint32_t> product{0};
+        std::atomic<double> oldPrice{0.0};
+        std::atomic<double> newPrice{0.0};
+        std::atomic<uint64_t> version{0};
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    uint64_t mask;
+    std::atomic<uint64_t> head{0};
+
+    mutable std::shared_mutex namesMutex;
+    std::unordered_map<std::string, uint32_t> handles;
+    std::deque<std::string> names;
+};
+
+#endif // PRICE_CHANGE_FEED_H
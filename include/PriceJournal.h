@@ -0,0 +1,118 @@
+/**
+ * @file PriceJournal.h
+ * @brief 价格变更预写日志（WAL）+ 快照 + 崩溃恢复
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#ifndef PRICE_JOURNAL_H
+#define PRICE_JOURNAL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+class ThreadSafePriceTable;
+
+/**
+ * @brief 日志配置
+ */
+struct JournalConfig {
+    int groupCommitMs = 5;                    // 组提交最长等待时间
+    uint64_t snapshotEveryRecords = 1000000;  // 每写入多少条记录触发一次快照（0 表示关闭）
+    bool syncToDisk = true;                   // 每次组提交后 fsync
+};
+
+/**
+ * @brief 价格表的追加式二进制 WAL
+ *
+ * 目录布局：
+ *   wal-<gen>.log   日志段，按代号递增；每批记录带长度与校验和，尾部残缺的批次在恢复时丢弃
+ *   snapshot.bin    压缩快照，记录其已覆盖的最大日志段代号
+ *
+ * 写入路径：ThreadSafePriceTable 发布新版本后按版本号依次调用 append() 把记录放入内存缓冲，
+ * 后台线程把缓冲成批写入并 fsync（组提交），因此日志顺序与价格表修改顺序一致。
+ * 快照：先切换到新日志段，再读取价格表写快照，最后删除已被覆盖的旧段；
+ * 快照期间的新记录落在新段中，恢复时按序重放（同一产品以最后一条为准）。
+ */
+class PriceJournal {
+public:
+    /**
+     * @brief 打开日志目录：先从快照 + 日志恢复 table，再挂接到 table 上记录后续修改
+     */
+    PriceJournal(const std::string& directory, ThreadSafePriceTable& table,
+                 const JournalConfig& config = JournalConfig());
+    ~PriceJournal();
+
+    PriceJournal(const PriceJournal&) = delete;
+    PriceJournal& operator=(const PriceJournal&) = delete;
+
+    /**
+     * @brief 追加一条价格记录（由 ThreadSafePriceTable 按同一产品的版本顺序调用）
+     * @return 记录序号，可用于 waitDurable()
+     */
+    uint64_t append(const std::string& productId, double price);
+
+    /**
+     * @brief 等待指定序号之前的记录全部落盘
+     */
+    void waitDurable(uint64_t lsn);
+
+    /**
+     * @brief 等待当前所有记录落盘
+     */
+    void flush();
+
+    /**
+     * @brief 立即生成快照并清理旧日志段（同步执行）
+     */
+    void checkpoint();
+
+    /**
+     * @brief 从目录恢复价格表（不挂接日志），返回重放的日志记录数
+     */
+    static size_t recover(const std::string& directory, ThreadSafePriceTable& table);
+
+    size_t getRecoveredRecords() const { return recoveredRecords; }
+
+private:
+    std::string directory;
+    ThreadSafePriceTable& table;
+    JournalConfig config;
+    size_t recoveredRecords = 0;
+
+    // 由 append() 填充，写线程整批取走
+    std::string pending;
+    uint32_t pendingCount = 0;
+    uint64_t nextLsn = 1;
+    uint64_t durableLsn = 0;
+    uint64_t recordsSinceSnapshot = 0;
+
+    // 仅由写线程访问
+    std::FILE* segment = nullptr;
+    uint64_t generation = 0;
+
+    bool rotateRequested = false;
+    uint64_t rotatedGeneration = 0;   // 最近一次切换后旧段的代号
+
+    std::mutex journalMutex;
+    std::condition_variable writerCV;
+    std::condition_variable durableCV;
+    std::atomic<bool> stopFlag;
+    std::thread writerThread;
+
+    std::mutex snapshotMutex;         // 同一时间只允许一个快照
+    std::thread snapshotThread;
+
+    void writerThreadFunc();
+    void openSegment(uint64_t gen);
+    void writeSnapshot(uint64_t coveredGeneration);
+    std::string segmentPath(uint64_t gen) const;
+};
+
+#endif // PRICE_JOURNAL_H
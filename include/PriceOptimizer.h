@@ -0,0 +1,82 @@
+/**
+ * @file PriceOptimizer.h
+ * @brief 收益 / 毛利最优定价求解 - 收益闭式解，毛利批量网格粗搜 + 黄金分割细化
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#ifndef PRICE_OPTIMIZER_H
+#define PRICE_OPTIMIZER_H
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @brief 优化目标
+ */
+enum class PriceObjective {
+    REVENUE,  // 最大化 price × 成交量
+    MARGIN    // 最大化 (price - unitCost) × 成交量
+};
+
+/**
+ * @brief 价格约束（默认与 PricingStrategy::clampPrice 的区间一致）
+ */
+struct OptimizerConstraints {
+    double minMultiplier = 0.5;          // 下限 = basePrice × minMultiplier
+    double maxMultiplier = 2.0;          // 上限 = basePrice × maxMultiplier
+    double maxCompetitorPremium = 0.05;  // 有竞品价时上限再收紧到 competitorPrice × (1 + premium)
+};
+
+/**
+ * @brief 单个 SKU 的定价问题（常弹性需求曲线 q(p) = q0 × (p / p0)^e）
+ */
+struct PriceProblem {
+    double basePrice = 0.0;        // 参考价 p0
+    double referenceDemand = 0.0;  // 参考价下规划期内的累计需求 q0（与 stock 同一期间，如补货提前期）
+    double elasticity = -1.2;      // 价格弹性 e（ElasticityEstimator 的输出）
+    int stock = 0;                 // 可售库存，成交量不超过库存
+    double unitCost = 0.0;         // 单位成本（MARGIN 目标使用）
+    double competitorPrice = 0.0;  // 0 表示无竞品约束
+};
+
+/**
+ * @brief 求解结果
+ */
+struct PriceSolution {
+    double price = 0.0;
+    double expectedUnits = 0.0;
+    double objective = 0.0;
+};
+
+/**
+ * @brief 批量最优定价求解器
+ *
+ * REVENUE：常弹性下收益在库存约束外正比于 p^(1+e)，最优价有闭式解
+ * （e < -1 时为恰好售完库存的价格，否则为上限），再夹到约束区间内。
+ * MARGIN：在 log 价格上先做定点网格粗搜，再在最优格点两侧做固定轮数的黄金分割，
+ * 所有 SKU 按相同步数同步推进。整批按线程分块并行。
+ */
+class PriceOptimizer {
+public:
+    explicit PriceOptimizer(PriceObjective objective = PriceObjective::REVENUE,
+                            const OptimizerConstraints& constraints = {});
+
+    PriceSolution solve(const PriceProblem& problem) const;
+
+    /**
+     * @param numThreads 线程数，0 表示使用硬件并发数
+     */
+    std::vector<PriceSolution> solveBatch(const std::vector<PriceProblem>& problems,
+                                          unsigned numThreads = 0) const;
+
+private:
+    PriceObjective objective;
+    OptimizerConstraints constraints;
+
+    void priceBounds(const PriceProblem& problem, double& lower, double& upper) const;
+    PriceSolution solveRevenue(const PriceProblem& problem) const;
+    void solveRange(const PriceProblem* problems, PriceSolution* out, size_t count) const;
+};
+
+#endif // PRICE_OPTIMIZER_H
@@ -0,0 +1,162 @@
+/**
+ * @file PriceSeriesStore.h
+ * @brief 按产品的价格时间序列存储 - Gorilla 压缩（时间戳二阶差分 + 浮点 XOR）
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#ifndef PRICE_SERIES_STORE_H
+#define PRICE_SERIES_STORE_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 一个价格采样点
+ */
+struct PricePoint {
+    int64_t timestamp;  // Unix 秒
+    double price;
+};
+
+/**
+ * @brief 降采样结果（每个时间桶的 OHLC）
+ */
+struct PriceBucket {
+    int64_t start = 0;
+    double open = 0.0;
+    double high = 0.0;
+    double low = 0.0;
+    double close = 0.0;
+    uint32_t count = 0;
+};
+
+/**
+ * @brief Gorilla 压缩块（定长：每块最多 kPointsPerBlock 个点）
+ *
+ * 时间戳：首点原样存储，之后存二阶差分（规律采样时每点 1 bit）
+ * 价格：与前值 XOR，相同为 1 bit，否则只存有效位
+ */
+class GorillaBlock {
+public:
+    static constexpr uint32_t kPointsPerBlock = 1024;
+
+    bool full() const { return count >= kPointsPerBlock; }
+    uint32_t size() const { return count; }
+    int64_t firstTimestamp() const { return firstTs; }
+    int64_t lastTimestamp() const { return prevTs; }
+    size_t memoryBytes() const { return words.capacity() * sizeof(uint64_t) + sizeof(*this); }
+
+    void append(int64_t timestamp, double price);
+
+    /**
+     * @brief 顺序解码，对每个点调用 fn(timestamp, price)；fn 返回 false 时提前结束
+     */
+    template <typename Fn>
+    void forEach(Fn&& fn) const;
+
+    /**
+     * @brief 封存：释放写入缓冲多余容量
+     */
+    void seal() { words.shrink_to_fit(); }
+
+private:
+    std::vector<uint64_t> words;
+    uint64_t bitCount = 0;
+    uint32_t count = 0;
+
+    int64_t firstTs = 0;
+    int64_t prevTs = 0;
+    int64_t prevDelta = 0;
+    uint64_t prevBits = 0;
+    uint8_t prevLeading = 0xFF;  // 0xFF 表示尚无 XOR 窗口
+    uint8_t prevTrailing = 0;
+
+    void writeBits(uint64_t value, int bits);
+
+    friend class GorillaReader;
+};
+
+/**
+ * @brief 块内顺序读取器
+ */
+class GorillaReader {
+public:
+    explicit GorillaReader(const GorillaBlock& block) : block(block) {}
+    bool next(int64_t& timestamp, double& price);
+
+private:
+    const GorillaBlock& block;
+    uint64_t bitPos = 0;
+    uint32_t index = 0;
+    int64_t ts = 0;
+    int64_t delta = 0;
+    uint64_t bits = 0;
+    uint8_t leading = 0;
+    uint8_t trailing = 0;
+
+    uint64_t readBits(int n);
+};
+
+template <typename Fn>
+void GorillaBlock::forEach(Fn&& fn) const {
+    GorillaReader reader(*this);
+    int64_t ts;
+    double price;
+    while (reader.next(ts, price)) {
+        if (!fn(ts, price)) {
+            return;
+        }
+    }
+}
+
+/**
+ * @brief 多产品价格时间序列存储（线程安全）
+ * 每个产品一串定长压缩块，块头记录时间范围用于区间查询裁剪。
+ * 同一产品的时间戳应单调不减，乱序到达的点会被钳制到上一个时间戳。
+ */
+class PriceSeriesStore {
+public:
+    void append(const std::string& productId, int64_t timestamp, double price);
+
+    /**
+     * @brief 区间查询 [from, to]
+     */
+    std::vector<PricePoint> range(const std::string& productId, int64_t from, int64_t to) const;
+
+    /**
+     * @brief 降采样：按 bucketSeconds 对齐分桶，每桶输出 OHLC
+     */
+    std::vector<PriceBucket> downsample(const std::string& productId, int64_t from, int64_t to,
+                                        int64_t bucketSeconds) const;
+
+    /**
+     * @brief 最新价格点（无数据时返回 false）
+     */
+    bool latest(const std::string& productId, PricePoint& point) const;
+
+    std::vector<std::string> products() const;
+    size_t pointCount() const;
+    size_t memoryBytes() const;
+
+private:
+    struct Series {
+        mutable std::mutex mutex;
+        std::vector<GorillaBlock> blocks;  // 最后一块为写入中的块
+        int64_t lastTimestamp = INT64_MIN;
+        double lastPrice = 0.0;
+        size_t points = 0;
+    };
+
+    mutable std::shared_mutex mapMutex;
+    std::map<std::string, std::unique_ptr<Series>> series;
+
+    const Series* find(const std::string& productId) const;
+};
+
+#endif // PRICE_SERIES_STORE_H
@@ -0,0 +1,97 @@
+/**
+ * @file PricingArena.h
+ * @brief 定价周期内存池 - 每线程单调分配，一个周期结束后整体释放
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#ifndef PRICING_ARENA_H
+#define PRICING_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <string>
+
+namespace pricing {
+
+/**
+ * @brief 从当前周期内存池分配的字符串
+ */
+using ArenaString = std::pmr::string;
+
+/**
+ * @brief 单个工作线程的周期内存池
+ *
+ * 一次定价任务里的临时对象（产品名、策略说明、日志文本）都从预分配的
+ * 缓冲中顺序切分，reset() 时整体归还，不逐个 free。某个周期用量超出缓冲时
+ * 溢出部分向堆申请，并在 reset() 时按高水位扩大缓冲，稳态下不再触发堆分配。
+ */
+class CycleArena {
+public:
+    explicit CycleArena(size_t initialBytes = 16 * 1024);
+    CycleArena(const CycleArena&) = delete;
+    CycleArena& operator=(const CycleArena&) = delete;
+
+    std::pmr::memory_resource* resource() { return &*buffer; }
+
+    /**
+     * @brief 释放本周期的全部分配
+     */
+    void reset();
+
+    size_t capacity() const { return storageSize; }
+    uint64_t spillCount() const { return spills; }  // 缓冲扩容次数
+
+    /**
+     * @brief 当前线程的内存池
+     */
+    static CycleArena& forThisThread();
+
+private:
+    // 统计溢出到堆上的字节数，用于决定下个周期的缓冲大小
+    class SpillCounter : public std::pmr::memory_resource {
+    public:
+        size_t bytes = 0;
+
+    private:
+        void* do_allocate(size_t size, size_t alignment) override;
+        void do_deallocate(void* p, size_t size, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+    };
+
+    SpillCounter upstream;
+    std::unique_ptr<std::byte[]> storage;
+    size_t storageSize;
+    std::optional<std::pmr::monotonic_buffer_resource> buffer;
+    uint64_t spills = 0;
+};
+
+/**
+ * @brief 在作用域内把 arena 设为当前线程的分配来源，离开时 reset
+ * 嵌套使用同一个 arena 时只有最外层会 reset。
+ */
+class ArenaScope {
+public:
+    explicit ArenaScope(CycleArena& arena);
+    ~ArenaScope();
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+private:
+    CycleArena& arena;
+    CycleArena* previous;
+};
+
+/**
+ * @brief 当前线程的分配来源：处于 ArenaScope 内时为周期内存池，否则为普通堆
+ */
+std::pmr::memory_resource* currentResource();
+
+}  // namespace pricing
+
+#endif // PRICING_ARENA_H
@@ -3,6 +3,8 @@
 #include <string>
 #include <ctime>
 
+#include "PricingArena.h"
+
 /**
  * @brief Dynamic Pricing Strategy for Consumer Electronics
  * @author Zhou Lexian (124090944)
@@ -16,14 +18,15 @@
 
 namespace pricing {
 
+// 字符串字段默认从当前定价周期的内存池分配 (see PricingArena.h).
 struct Product {
-    std::string id;
-    std::string name;
-    std::string category;
+    ArenaString id{currentResource()};
+    ArenaString name{currentResource()};
+    ArenaString category{currentResource()};
     double basePrice{0.0};
     int stock{0};
     bool isNewModel{false};
-    std::string series;
+    ArenaString series{currentResource()};
 };
 
 struct MarketContext {
@@ -35,6 +38,8 @@ struct MarketContext {
     int purchaseCount{0};
     std::tm currentTime{};
     bool newerModelInSeriesAvailable{false};
+    double priceElasticity{0.0};  // 实测 log-log 价格弹性，0 表示未知 (see ElasticityEstimator)
+    double plannedMarkdown{-1.0};  // 清仓计划给出的今日折扣，<0 表示无计划 (see ClearancePlanner)
 };
 
 struct PricingResult {
@@ -44,7 +49,7 @@ struct PricingResult {
     double competitorFactor{0.0};
     double demandFactor{0.0};
     double timeFactor{0.0};
-    std::string strategyExplanation;
+    ArenaString strategyExplanation{currentResource()};
 };
 
 class PricingStrategy {
@@ -0,0 +1,128 @@
+/**
+ * @file ProductCatalog.h
+ * @brief 产品目录元数据 - 类别、系列、新款标记与生命周期的唯一来源
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#ifndef PRODUCT_CATALOG_H
+#define PRODUCT_CATALOG_H
+
+#include <cstdint>
+#include <deque>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+
+#include "SeriesIndex.h"
+
+/**
+ * @brief 产品类别（定价、库存预警、可视化共用）
+ */
+enum class ProductCategory {
+    SMARTPHONE,
+    LAPTOP,
+    GPU,
+    TABLET,
+    GENERAL
+};
+
+/**
+ * @brief 产品生命周期阶段
+ */
+enum class Lifecycle {
+    INTRODUCTION,
+    GROWTH,
+    MATURITY,
+    DECLINE
+};
+
+/**
+ * @brief 类别的小写键（目录文件与 pricing::Product::category 使用）
+ */
+const char* categoryKey(ProductCategory category);
+bool parseCategory(const std::string& text, ProductCategory& category);
+
+const char* lifecycleKey(Lifecycle lifecycle);
+bool parseLifecycle(const std::string& text, Lifecycle& lifecycle);
+
+/**
+ * @brief 解析 "YYYY-MM-DD" 为自 1970-01-01 起的天数（日超出当月天数时返回 false）
+ */
+bool parseCivilDate(const std::string& text, int64_t& days);
+
+/**
+ * @brief 一个产品的目录元数据（登记后不再修改）
+ */
+struct ProductInfo {
+    std::string id;
+    std::string name;
+    ProductCategory category = ProductCategory::GENERAL;
+    std::string series;
+    bool isNewModel = false;
+    Lifecycle lifecycle = Lifecycle::MATURITY;
+    int64_t launchDay = INT64_MIN;  // 自 1970-01-01 起的天数，INT64_MIN 表示未知
+};
+
+/**
+ * @brief 产品目录
+ *
+ * 启动时从目录文件加载一次，每个产品分配一个稠密句柄；之后各模块持有句柄，
+ * 通过 info(handle) 直接按下标取元数据。目录中没有的产品在首次 resolve()
+ * 时按 ID 推断元数据并登记，推断规则只存在于 inferFromId() 一处。
+ *
+ * 目录文件格式（CSV，首行为表头）：
+ *   productId,name,category,series,isNewModel,lifecycle,launchDate
+ */
+class ProductCatalog {
+public:
+    static constexpr uint32_t kInvalidHandle = UINT32_MAX;
+
+    /**
+     * @brief 加载目录文件，返回成功登记的产品数（文件无法打开时返回 0）
+     */
+    size_t loadFromFile(const std::string& filename);
+
+    /**
+     * @brief 登记产品（已存在时返回原句柄，不覆盖）
+     * 新品上市也走这里：系列索引随之增量更新，同系列旧款立即能查到新款。
+     */
+    uint32_t registerProduct(const ProductInfo& info);
+
+    /**
+     * @brief 产品 ID -> 句柄；未登记的产品按 ID 推断后登记
+     */
+    uint32_t resolve(const std::string& productId);
+
+    /**
+     * @brief 产品 ID -> 句柄；未登记时返回 kInvalidHandle
+     */
+    uint32_t find(const std::string& productId) const;
+
+    /**
+     * @brief 按句柄取元数据（O(1)，返回的引用在目录生命周期内有效）
+     */
+    const ProductInfo& info(uint32_t handle) const;
+
+    size_t size() const;
+
+    /**
+     * @brief 截至 day（自 1970-01-01 起的天数）同系列是否已有更新的型号上市，O(1)
+     */
+    bool hasNewerInSeries(uint32_t handle, int64_t day) const;
+
+    /**
+     * @brief 目录缺失时的兜底推断（按 ID 中的关键字）
+     */
+    static ProductInfo inferFromId(const std::string& productId);
+
+private:
+    mutable std::shared_mutex mutex;
+    std::deque<ProductInfo> products;  // deque 扩容不移动已有元素
+    std::unordered_map<std::string, uint32_t> handles;
+    SeriesIndex seriesIndex;
+
+    uint32_t registerLocked(const ProductInfo& info);
+};
+
+#endif // PRODUCT_CATALOG_H
@@ -0,0 +1,137 @@
+/**
+ * @file RepricingScheduler.h
+ * @brief 基于时间轮的定时重定价调度器 - 每个 SKU 按自己的周期触发
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#ifndef REPRICING_SCHEDULER_H
+#define REPRICING_SCHEDULER_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief 调度器统计信息
+ */
+struct SchedulerStats {
+    uint64_t dispatched = 0;       // 已派发的触发次数
+    uint64_t coalesced = 0;        // 被合并的重复触发次数
+    uint64_t missedDeadlines = 0;  // 晚于截止时间才派发的次数
+    size_t activeTimers = 0;       // 当前注册的定时器数量
+};
+
+/**
+ * @brief 哈希时间轮调度器
+ *
+ * 单个调度线程按固定 tick 推进时间轮，到期的 SKU 通过回调派发，
+ * 不为每个定时器创建线程或 sleep。周期长于一圈的定时器记录绝对 tick，
+ * 在所在槽位被扫描时判断是否到期（hashed wheel with rounds）。
+ *
+ * - 同一 tick 内对同一 SKU 的多次触发（周期到期 + 手动触发）只派发一次
+ * - 调度落后时，跳过的周期合并为一次派发，并计入 missed deadline
+ */
+class RepricingScheduler {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Callback = std::function<void(const std::string& sku)>;
+
+    /**
+     * @param callback 到期回调（在调度线程上执行，不持有内部锁）
+     * @param tick 时间轮精度
+     * @param wheelSlots 时间轮槽位数
+     */
+    explicit RepricingScheduler(Callback callback,
+                                std::chrono::milliseconds tick = std::chrono::milliseconds(100),
+                                size_t wheelSlots = 1024);
+    ~RepricingScheduler();
+
+    RepricingScheduler(const RepricingScheduler&) = delete;
+    RepricingScheduler& operator=(const RepricingScheduler&) = delete;
+
+    /**
+     * @brief 注册或更新 SKU 的重定价周期（首次触发在一个周期之后）
+     */
+    void schedule(const std::string& sku, std::chrono::milliseconds cadence);
+
+    /**
+     * @brief 取消 SKU 的定时器
+     */
+    bool cancel(const std::string& sku);
+
+    /**
+     * @brief 在下一个 tick 立即触发一次（与同 tick 的周期触发合并）
+     */
+    bool triggerNow(const std::string& sku);
+
+    /**
+     * @brief 启动后台调度线程
+     */
+    void start();
+
+    /**
+     * @brief 停止调度线程（等待其退出）
+     */
+    void stop();
+
+    /**
+     * @brief 推进时间轮到指定时刻并派发到期任务（调度线程内部使用，也可手动驱动）
+     * @return 本次派发的任务数
+     */
+    size_t advance(Clock::time_point now);
+
+    SchedulerStats getStats() const;
+    uint64_t getMissedDeadlines(const std::string& sku) const;
+
+private:
+    struct TimerEntry {
+        std::string sku;
+        uint64_t cadenceTicks = 1;
+        uint64_t deadlineTick = 0;
+        uint64_t lastQueuedTick = UINT64_MAX;  // 同 tick 去重
+        uint64_t missed = 0;
+        bool active = false;
+        bool manualPending = false;
+    };
+
+    // 槽位中的节点：记录入槽时的 deadline，用于惰性删除过期节点
+    struct SlotNode {
+        uint32_t entry;
+        uint64_t deadlineTick;
+    };
+
+    Callback callback;
+    std::chrono::milliseconds tickDuration;
+    Clock::time_point epoch;
+
+    std::vector<std::vector<SlotNode>> wheel;
+    std::vector<TimerEntry> entries;
+    std::vector<uint32_t> freeEntries;
+    std::unordered_map<std::string, uint32_t> index;
+    std::vector<uint32_t> manualQueue;
+    uint64_t currentTick = 0;
+
+    uint64_t dispatchedCount = 0;
+    uint64_t coalescedCount = 0;
+    uint64_t missedCount = 0;
+
+    mutable std::mutex wheelMutex;
+    std::condition_variable cv;
+    std::atomic<bool> stopFlag;
+    std::thread schedulerThread;
+
+    uint64_t toTicks(std::chrono::milliseconds d) const;
+    void insertLocked(uint32_t id);
+    void collectDueLocked(uint64_t tick, uint64_t nowTick, std::vector<std::string>& due);
+    void schedulerThreadFunc();
+};
+
+#endif // REPRICING_SCHEDULER_H
@@ -0,0 +1,88 @@
+/**
+ * @file SalesAnomalyFilter.h
+ * @brief 销量异常过滤 - 按产品滚动中位数 / MAD 的流式稳健过滤
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#ifndef SALES_ANOMALY_FILTER_H
+#define SALES_ANOMALY_FILTER_H
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "DataLoader.h"
+
+/**
+ * @brief 异常行的处理方式
+ */
+enum class AnomalyAction {
+    FLAG,      // 只标记（Sale::flagged），销量保持原值
+    WINSORIZE  // 标记并把销量截断到 中位数 ± threshold × 稳健标准差
+};
+
+/**
+ * @brief 过滤参数
+ */
+struct AnomalyConfig {
+    int window = 15;         // 每个产品保留最近多少行（上限 64）
+    int minSamples = 5;      // 窗口内样本少于该数时不判定
+    double threshold = 3.5;  // 稳健 z 分数阈值
+    AnomalyAction action = AnomalyAction::WINSORIZE;
+};
+
+/**
+ * @brief 一条被标记的记录
+ */
+struct SalesAnomaly {
+    size_t row = 0;  // 在导入序列中的行号（从 0 开始）
+    std::string date;
+    std::string productId;
+    int original = 0;     // 原始销量
+    int replacement = 0;  // 写回的销量（FLAG 模式下等于原值）
+    double score = 0.0;   // 稳健 z 分数 |x - median| / (1.4826 × MAD)
+};
+
+/**
+ * @brief 流式销量异常过滤器
+ *
+ * 每个产品维护最近 window 行的环形缓冲与有序副本：中位数直接按下标读取，
+ * MAD 在窗口内做一次 nth_element。窗口长度固定，每行代价为常数，
+ * 不随历史长度增长。窗口中保存原始值，真实的水平变化约半个窗口后被吸收。
+ */
+class SalesAnomalyFilter {
+public:
+    explicit SalesAnomalyFilter(const AnomalyConfig& config = {});
+
+    /**
+     * @brief 检查一行并按配置处理
+     * @param sale 待检查的记录（被标记时设置 flagged，WINSORIZE 模式下改写 sales）
+     * @param row 该行的行号
+     * @return 该行是否被标记
+     */
+    bool observe(Sale& sale, size_t row);
+
+    const std::vector<SalesAnomaly>& anomalies() const;
+
+    void clear();
+
+private:
+    struct ProductWindow {
+        std::vector<double> ring;    // 按到达顺序
+        std::vector<double> sorted;  // 同一批值的有序副本
+        size_t next = 0;
+    };
+
+    AnomalyConfig config;
+    std::unordered_map<std::string, ProductWindow> windows;
+    std::vector<SalesAnomaly> flagged;
+    std::vector<double> scratch;
+
+    static double median(const std::vector<double>& sorted);
+    double mad(const std::vector<double>& sorted, double center);
+    static void push(ProductWindow& w, double value, size_t capacity);
+};
+
+#endif // SALES_ANOMALY_FILTER_H
@@ -0,0 +1,78 @@
+/**
+ * @file SalesColumns.h
+ * @brief 压缩销售列 - 销量参考帧打包、库存差分打包、价格游程编码，按块 SIMD 解码
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#ifndef SALES_COLUMNS_H
+#define SALES_COLUMNS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class DailySeries;
+
+/**
+ * @brief 单个产品的压缩日销售列
+ *
+ * 每 128 天为一块，按块独立编码：
+ *  - 销量：参考帧（块内最小值）+ 按块内最大偏移的位宽打包
+ *  - 库存：块首值 + 相邻差分 zigzag 后位宽打包
+ *  - 价格：按价格不变的区间做游程编码（全局，不分块）
+ * 打包采用 4 路纵向布局（第 i 个值放在第 i % 4 路），一个 128 位寄存器一次解出 4 个值。
+ * 最后一个不满的块保持未压缩，追加时满 128 天再封块。
+ */
+class SalesColumns {
+public:
+    static constexpr size_t kBlockSize = 128;
+
+    /**
+     * @brief 由稠密日序列构建（缺失天销量为 0，价格与库存沿用前值）
+     */
+    static SalesColumns fromSeries(const DailySeries& series);
+
+    void append(int32_t sales, int32_t stock, double price);
+
+    size_t size() const;
+    size_t blockCount() const;  // 含未封块的尾块
+
+    /**
+     * @brief 解码第 block 块，返回该块的天数（out 至少 kBlockSize 个元素）
+     */
+    size_t decodeSales(size_t block, int32_t* out) const;
+    size_t decodeStock(size_t block, int32_t* out) const;
+    size_t decodePrices(size_t block, double* out) const;
+
+    /**
+     * @brief 压缩后占用的字节数（不含 vector 预留容量）
+     */
+    size_t memoryBytes() const;
+
+private:
+    struct Block {
+        int32_t salesBase = 0;
+        int32_t stockFirst = 0;
+        uint32_t salesOffset = 0;  // 在 words 中的起始下标
+        uint32_t stockOffset = 0;
+        uint8_t salesBits = 0;
+        uint8_t stockBits = 0;
+    };
+
+    struct PriceRun {
+        uint64_t start = 0;  // 该价格首次出现的天序号
+        double price = 0.0;
+    };
+
+    std::vector<Block> blocks;
+    std::vector<uint32_t> words;
+    std::vector<PriceRun> priceRuns;
+    std::vector<int32_t> pendingSales;  // 未封块的尾块
+    std::vector<int32_t> pendingStock;
+    size_t count = 0;
+
+    void sealBlock();
+};
+
+#endif // SALES_COLUMNS_H
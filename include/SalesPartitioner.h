@@ -0,0 +1,67 @@
+/**
+ * @file SalesPartitioner.h
+ * @brief 外存分区 - 按产品哈希把销售文件拆成磁盘分区，逐分区按产品分组处理
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#ifndef SALES_PARTITIONER_H
+#define SALES_PARTITIONER_H
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "DataLoader.h"
+
+/**
+ * @brief 分区参数
+ */
+struct PartitionConfig {
+    size_t memoryBudgetBytes = 256u << 20;        // 单个分区载入内存后的目标上限
+    std::string spillDirectory = "output/spill";  // 分区文件目录
+    size_t maxPartitions = 256;                   // 同时打开的分区文件数上限
+};
+
+/**
+ * @brief 外存销售数据分区器
+ *
+ * partition() 流式读取输入，按产品 ID 哈希写入 K 个分区文件（同一产品的记录保持原有顺序），
+ * K 由文件大小与内存预算决定；文件本身放得进预算时不拆分、直接读原文件。
+ * forEachProduct() 每次只载入一个分区，按产品分组后逐组回调，
+ * 内存占用由最大分区决定，与总历史长度无关。
+ */
+class SalesPartitioner {
+public:
+    using GroupCallback = std::function<void(const std::string& productId, std::vector<Sale>& rows)>;
+
+    explicit SalesPartitioner(const PartitionConfig& config = {});
+    ~SalesPartitioner();
+
+    SalesPartitioner(const SalesPartitioner&) = delete;
+    SalesPartitioner& operator=(const SalesPartitioner&) = delete;
+
+    /**
+     * @brief 拆分销售文件
+     * @return 是否成功（输入或分区文件无法打开时返回 false）
+     */
+    bool partition(const std::string& filename);
+
+    /**
+     * @brief 逐分区、逐产品回调；同一产品的所有记录在一次回调中给出
+     * @return 处理的产品数
+     */
+    size_t forEachProduct(const GroupCallback& callback) const;
+
+    size_t partitionCount() const;
+
+private:
+    PartitionConfig config;
+    std::vector<std::string> partitionFiles;
+    bool ownsFiles = false;  // 是否为自己写出的分区文件（析构时删除）
+
+    void removeFiles();
+};
+
+#endif // SALES_PARTITIONER_H
@@ -0,0 +1,131 @@
+/**
+ * @file SalesQuery.h
+ * @brief 销售聚合查询 - 按产品 / 类别 / 日期桶分组，分区哈希聚合并行执行，链式调用
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#ifndef SALES_QUERY_H
+#define SALES_QUERY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "DataLoader.h"
+
+class ProductCatalog;
+
+/**
+ * @brief 分组键
+ */
+enum class GroupKey {
+    PRODUCT,
+    CATEGORY,  // 按目录类别（无目录时按产品 ID 推断）
+    DAY,       // YYYY-MM-DD
+    WEEK,      // 周一的日期
+    MONTH      // YYYY-MM
+};
+
+/**
+ * @brief 被聚合的量
+ */
+enum class Measure {
+    UNITS,    // 销量
+    REVENUE,  // 销量 × 价格
+    PRICE,
+    STOCK
+};
+
+/**
+ * @brief 聚合函数
+ */
+enum class AggregateOp {
+    SUM,
+    MEAN,
+    MIN,
+    MAX,
+    COUNT,
+    LAST  // 组内日期最晚的一行（同一天取后出现的行），如期末库存
+};
+
+/**
+ * @brief 一行结果：分组键的文本 + 各聚合值（顺序与添加聚合的顺序一致）
+ */
+struct AggregateRow {
+    std::vector<std::string> keys;
+    std::vector<double> values;
+};
+
+/**
+ * @brief 查询结果
+ */
+struct AggregateTable {
+    std::vector<std::string> columns;  // 如 product, week, sum(revenue)
+    std::vector<AggregateRow> rows;
+
+    bool writeCsv(const std::string& path) const;
+};
+
+/**
+ * @brief 销售记录上的分组聚合
+ *
+ *   SalesQuery(rows, &catalog)
+ *       .groupBy(GroupKey::PRODUCT)
+ *       .sum(Measure::REVENUE)
+ *       .orderBy(0)
+ *       .limit(10)
+ *       .run();
+ *
+ * 执行分两步：各线程扫描一段记录，在本地按分组键哈希分成 P 个分区预聚合；
+ * 然后第 p 个线程把所有线程的第 p 个分区合并。每个分组只由一个线程合并，
+ * 不需要加锁，结果与线程数无关（默认按分组键排序）。
+ * 查询只保存 rows 的引用，run() 返回前 rows 不能被修改。
+ */
+class SalesQuery {
+public:
+    static constexpr size_t kMaxKeys = 3;
+
+    explicit SalesQuery(const std::vector<Sale>& rows, const ProductCatalog* catalog = nullptr);
+
+    SalesQuery& groupBy(GroupKey key);
+    SalesQuery& where(std::function<bool(const Sale&)> predicate);
+
+    SalesQuery& sum(Measure measure);
+    SalesQuery& mean(Measure measure);
+    SalesQuery& min(Measure measure);
+    SalesQuery& max(Measure measure);
+    SalesQuery& last(Measure measure);
+    SalesQuery& count();
+
+    /**
+     * @brief 按第 column 个聚合值排序（默认降序），同值按分组键
+     */
+    SalesQuery& orderBy(size_t column, bool descending = true);
+    SalesQuery& limit(size_t rows);
+    SalesQuery& threads(unsigned numThreads);
+
+    AggregateTable run() const;
+
+private:
+    struct Aggregate {
+        AggregateOp op;
+        Measure measure;
+    };
+
+    const std::vector<Sale>& rows;
+    const ProductCatalog* catalog;
+    std::vector<GroupKey> keys;
+    std::vector<Aggregate> aggregates;
+    std::function<bool(const Sale&)> predicate;
+    size_t orderColumn = SIZE_MAX;  // SIZE_MAX 表示按分组键排序
+    bool descending = true;
+    size_t rowLimit = SIZE_MAX;
+    unsigned numThreads = 0;  // 0 表示硬件并发数
+
+    SalesQuery& add(AggregateOp op, Measure measure);
+};
+
+#endif // SALES_QUERY_H
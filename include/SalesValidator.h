@@ -0,0 +1,111 @@
+/**
+ * @file SalesValidator.h
+ * @brief 销售数据校验与去重 - 列式范围检查 + 按产品分区并行去重，拒绝行写入旁路文件
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#ifndef SALES_VALIDATOR_H
+#define SALES_VALIDATOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "DataLoader.h"
+
+/**
+ * @brief 同一 (日期, 产品) 出现多次时保留哪一条
+ */
+enum class DedupPolicy {
+    KEEP_FIRST,
+    KEEP_LAST  // 上游补发的更正记录排在后面时使用
+};
+
+/**
+ * @brief 校验参数
+ */
+struct ValidationConfig {
+    int maxDailySales = 1000000;  // 单日销量上限
+    int maxStock = 100000000;     // 库存上限
+    double maxPrice = 1e7;        // 价格上限（下限为大于 0）
+    DedupPolicy dedup = DedupPolicy::KEEP_FIRST;
+    bool recordRowNumbers = true;  // 输入不是原文件顺序时（如外存模式按产品分组）关闭
+};
+
+/**
+ * @brief 一条被拒绝的记录
+ */
+struct RejectedRow {
+    static constexpr size_t kUnknownRow = SIZE_MAX;
+
+    size_t row = 0;        // 在输入中的行号（从 0 开始），kUnknownRow 表示未记录
+    uint8_t reasons = 0;   // SalesValidator::kBadSales 等标志位的组合
+    Sale sale;
+};
+
+/**
+ * @brief 本次校验的统计
+ */
+struct ValidationReport {
+    size_t checked = 0;
+    size_t accepted = 0;
+    size_t badSales = 0;
+    size_t badStock = 0;
+    size_t badPrice = 0;
+    size_t badDate = 0;
+    size_t duplicates = 0;
+};
+
+/**
+ * @brief 校验与去重
+ *
+ * 1. 分块并行：把销量 / 库存 / 价格取成列，用无分支的比较生成每行的拒绝标志，
+ *    同时解析日期并按产品 ID 哈希分区；
+ * 2. 每个分区由一个线程按行序扫描，用 (产品, 天) 的 64 位键做哈希去重；
+ * 3. 按原顺序压缩保留行，拒绝行连同原因留待写入旁路文件。
+ * 同一产品只落在一个分区，去重不需要跨线程同步。
+ */
+class SalesValidator {
+public:
+    static constexpr uint8_t kBadSales = 1 << 0;
+    static constexpr uint8_t kBadStock = 1 << 1;
+    static constexpr uint8_t kBadPrice = 1 << 2;
+    static constexpr uint8_t kBadDate = 1 << 3;
+    static constexpr uint8_t kDuplicate = 1 << 4;
+
+    explicit SalesValidator(const ValidationConfig& config = {});
+
+    /**
+     * @brief 原地校验并删除拒绝行（保留行的相对顺序不变）
+     * @param numThreads 线程数，0 表示使用硬件并发数
+     */
+    ValidationReport validate(std::vector<Sale>& rows, unsigned numThreads = 0);
+
+    /**
+     * @brief 累计的拒绝行（多次 validate 的结果依次追加，flushRejects 后清空）
+     */
+    const std::vector<RejectedRow>& rejects() const;
+
+    /**
+     * @brief 写出拒绝行：row,reason,date,productId,sales,price,stock（行号未记录时 row 为空）
+     */
+    bool writeRejects(const std::string& path) const;
+
+    /**
+     * @brief 把累计的拒绝行追加到 path 后清空，外存模式用它把拒绝行占用的内存限制在一批以内
+     *
+     * 本对象第一次调用时截断文件并写表头，之后只追加；格式与 writeRejects 相同。
+     */
+    bool flushRejects(const std::string& path);
+
+    static std::string reasonText(uint8_t reasons);
+
+private:
+    ValidationConfig config;
+    std::vector<RejectedRow> rejected;
+    bool rejectsStarted = false;  // flushRejects 已写过表头
+};
+
+#endif // SALES_VALIDATOR_H
@@ -0,0 +1,60 @@
+/**
+ * @file SeriesIndex.h
+ * @brief 产品系列谱系索引 - 预计算每个产品的"同系列新款上市日"
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#ifndef SERIES_INDEX_H
+#define SERIES_INDEX_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief 系列谱系索引
+ *
+ * 每个系列按上市日排序保存成员；每个产品预存"同系列中晚于它上市的最早新款
+ * 的上市日"，于是"截至日期 D 是否已有新款"只需一次比较。登记新品时只更新
+ * 同系列中更早上市的成员，代价为该系列规模，与目录总规模无关。
+ * 上市日未知的产品不参与谱系比较。本类不加锁，由 ProductCatalog 负责同步。
+ */
+class SeriesIndex {
+public:
+    static constexpr int64_t kNever = INT64_MAX;
+
+    /**
+     * @brief 登记产品（handle 为目录句柄，需按顺序登记）
+     */
+    void addProduct(uint32_t handle, const std::string& series, int64_t launchDay);
+
+    /**
+     * @brief 同系列最早新款的上市日（天数），没有时为 kNever
+     */
+    int64_t newerLaunchDay(uint32_t handle) const {
+        return handle < newerDay.size() ? newerDay[handle] : kNever;
+    }
+
+    /**
+     * @brief 截至 day（含）同系列是否已有新款上市
+     */
+    bool hasNewerAsOf(uint32_t handle, int64_t day) const { return newerLaunchDay(handle) <= day; }
+
+    /**
+     * @brief 系列成员句柄（按上市日从早到晚）
+     */
+    std::vector<uint32_t> members(const std::string& series) const;
+
+private:
+    struct Member {
+        int64_t launchDay;
+        uint32_t handle;
+    };
+
+    std::unordered_map<std::string, std::vector<Member>> seriesMembers;
+    std::vector<int64_t> newerDay;  // 按句柄索引
+};
+
+#endif // SERIES_INDEX_H
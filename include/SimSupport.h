@@ -0,0 +1,111 @@
+/**
+ * @file SimSupport.h
+ * @brief 模拟器公共工具 - 可复现随机数与线程屏障
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#ifndef SIM_SUPPORT_H
+#define SIM_SUPPORT_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+
+namespace sim {
+
+/**
+ * @brief splitmix64：状态即种子，由 (seed, 实体, tick) 派生后结果与线程划分无关
+ */
+inline uint64_t nextRandom(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+/**
+ * @brief 均匀分布 [lo, hi)
+ */
+inline double uniform(uint64_t& state, double lo, double hi) {
+    return lo + (hi - lo) * (nextRandom(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+/**
+ * @brief 将多个键混合为一个随机数种子
+ */
+inline uint64_t mixSeed(uint64_t seed, uint64_t a, uint64_t b = 0) {
+    uint64_t state = seed ^ (a * 0x9E3779B97F4A7C15ULL);
+    state = nextRandom(state) ^ (b * 0xC2B2AE3D27D4EB4FULL);
+    return nextRandom(state);
+}
+
+/**
+ * @brief 公历日期 -> 自 1970-01-01 起的天数（与时区无关）
+ */
+inline int64_t daysFromCivil(int year, int month, int day) {
+    year -= month <= 2;
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned yoe = static_cast<unsigned>(year - era * 400);
+    const unsigned doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + static_cast<int64_t>(doe) - 719468;
+}
+
+/**
+ * @brief 公历某月的天数（含闰年二月）
+ */
+inline int daysInMonth(int year, int month) {
+    static constexpr int kDays[12] = {31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31};
+    const bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    return month == 2 && leap ? 29 : kDays[month - 1];
+}
+
+/**
+ * @brief 自 1970-01-01 起的天数 -> 公历日期
+ */
+inline void civilFromDays(int64_t days, int& year, int& month, int& day) {
+    days += 719468;
+    const int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+    const unsigned doe = static_cast<unsigned>(days - era * 146097);
+    const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const unsigned mp = (5 * doy + 2) / 153;
+    day = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+    month = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+    year = static_cast<int>(static_cast<int64_t>(yoe) + era * 400 + (month <= 2));
+}
+
+/**
+ * @brief 可重复使用的线程屏障（C++17 无 std::barrier）
+ */
+class TickBarrier {
+public:
+    explicit TickBarrier(int count) : threshold(count), waiting(0), generation(0) {}
+
+    // 最后一个到达的线程执行 onComplete 后再放行其他线程
+    template <typename F>
+    void arriveAndWait(F&& onComplete) {
+        std::unique_lock<std::mutex> lock(mutex);
+        const uint64_t gen = generation;
+        if (++waiting == threshold) {
+            onComplete();
+            waiting = 0;
+            generation++;
+            cv.notify_all();
+            return;
+        }
+        cv.wait(lock, [this, gen] { return generation != gen; });
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable cv;
+    int threshold;
+    int waiting;
+    uint64_t generation;
+};
+
+}  // namespace sim
+
+#endif // SIM_SUPPORT_H
@@ -23,11 +23,25 @@
 #include <iostream>
 #include <iomanip>
 #include <sstream>
+#include <functional>
+#include <memory_resource>
+#include <string_view>
+
+#include "RepricingScheduler.h"
+#include "PriceSeriesStore.h"
+#include "HeavyHitters.h"
+#include "ProductCatalog.h"
 
 // 前向声明
+class ElasticityEstimator;
 namespace pricing {
     class PricingStrategy;
 }
+class SimTask;
+class SimEventLoop;
+class PriceJournal;
+struct JournalConfig;
+class PriceChangeFeed;
 
 /**
  * @brief 商家信息结构
@@ -60,24 +74,71 @@ struct PricingTask {
  * @brief 价格记录（用于持久化）
  */
 struct PriceRecord {
-    std::string timestamp;
-    std::string merchantName;
-    std::string productId;
-    double originalPrice;
-    double adjustedPrice;
-    double adjustmentRate;
-    int stockLevel;
-    std::string status;  // "SUCCESS" or "FAILED"
+    // 支持 pmr 容器的 uses-allocator 构造：放入历史记录时字符串直接分配在历史内存池
+    using allocator_type = std::pmr::polymorphic_allocator<char>;
+    
+    std::pmr::string timestamp;
+    std::pmr::string merchantName;
+    std::pmr::string productId;
+    double originalPrice = 0.0;
+    double adjustedPrice = 0.0;
+    double adjustmentRate = 0.0;
+    int stockLevel = 0;
+    std::pmr::string status;  // "SUCCESS" or "FAILED"
+    
+    PriceRecord() = default;
+    explicit PriceRecord(const allocator_type& alloc)
+        : timestamp(alloc), merchantName(alloc), productId(alloc), status(alloc) {}
+    PriceRecord(const PriceRecord& other) = default;
+    PriceRecord(PriceRecord&& other) = default;
+    PriceRecord(const PriceRecord& other, const allocator_type& alloc)
+        : timestamp(other.timestamp, alloc), merchantName(other.merchantName, alloc),
+          productId(other.productId, alloc), originalPrice(other.originalPrice),
+          adjustedPrice(other.adjustedPrice), adjustmentRate(other.adjustmentRate),
+          stockLevel(other.stockLevel), status(other.status, alloc) {}
+    PriceRecord(PriceRecord&& other, const allocator_type& alloc)
+        : timestamp(std::move(other.timestamp), alloc),
+          merchantName(std::move(other.merchantName), alloc),
+          productId(std::move(other.productId), alloc), originalPrice(other.originalPrice),
+          adjustedPrice(other.adjustedPrice), adjustmentRate(other.adjustmentRate),
+          stockLevel(other.stockLevel), status(std::move(other.status), alloc) {}
+    PriceRecord& operator=(const PriceRecord& other) = default;
+    PriceRecord& operator=(PriceRecord&& other) = default;
+};
+
+/**
+ * @brief 带版本号的价格读取结果
+ */
+struct VersionedPrice {
+    double price = 0.0;
+    uint64_t version = 0;  // 0 表示产品不存在；每次成功写入加 1
 };
 
 /**
  * @brief 线程安全的价格表
- * 使用读写锁优化并发读性能
+ * 读写锁只保护表结构（插入新产品时独占）；已有产品的价格用每条目的
+ * 版本号（seqlock）更新，读不加锁重试，写通过 CAS 抢占版本号，
+ * 同一热点 SKU 的并发改价不会丢失更新，也不需要全局写锁。
  */
 class ThreadSafePriceTable {
 private:
-    std::map<std::string, double> prices;
-    mutable std::shared_mutex rwMutex;  // 读写锁
+    struct PriceEntry {
+        // 偶数为稳定状态（版本 = seq / 2），奇数表示正在写入
+        std::atomic<uint64_t> seq{0};
+        std::atomic<double> price{0.0};
+        // 已写入日志与变更流的最新版本；写者发布 seq 后按版本号依次接力，读者不必等日志
+        std::atomic<uint64_t> logged{0};
+        uint32_t feedHandle = UINT32_MAX;  // 变更流中的产品句柄（仅由轮到记录的写者访问）
+    };
+    
+    std::map<std::string, PriceEntry> prices;
+    mutable std::shared_mutex rwMutex;  // 读写锁（保护表结构）
+    PriceJournal* journal = nullptr;    // 可选：写入期间记录价格变更
+    PriceChangeFeed* feed = nullptr;    // 可选：写入期间发布变更事件
+    
+    static VersionedPrice readEntry(const PriceEntry& entry);
+    bool tryWriteEntry(const std::string& productId, PriceEntry& entry,
+                       uint64_t expectedSeq, double newPrice);
     
 public:
     /**
@@ -86,10 +147,37 @@ public:
     double getPrice(const std::string& productId) const;
     
     /**
-     * @brief 设置产品价格（独占写）
+     * @brief 获取价格及其版本号
+     */
+    VersionedPrice getVersioned(const std::string& productId) const;
+    
+    /**
+     * @brief 设置产品价格（无条件覆盖）
      */
     void setPrice(const std::string& productId, double price);
     
+    /**
+     * @brief 乐观更新：仅当版本号仍为 expectedVersion 时写入
+     * expectedVersion 为 0 表示仅当产品尚不存在时插入
+     */
+    bool compareAndSet(const std::string& productId, uint64_t expectedVersion, double newPrice);
+    
+    /**
+     * @brief 原子读-改-写：fn(当前价格) 返回新价格，冲突时以最新价格重试
+     * fn 可能被调用多次，应无副作用；产品不存在时传入 0
+     * @return 最终提交的价格与版本号
+     */
+    template <typename Fn>
+    VersionedPrice update(const std::string& productId, Fn&& fn) {
+        while (true) {
+            VersionedPrice current = getVersioned(productId);
+            double newPrice = fn(current.price);
+            if (compareAndSet(productId, current.version, newPrice)) {
+                return VersionedPrice{newPrice, current.version + 1};
+            }
+        }
+    }
+    
     /**
      * @brief 原子操作：仅当新价格更低时更新
      */
@@ -104,6 +192,21 @@ public:
      * @brief 价格表大小
      */
     size_t size() const;
+    
+    /**
+     * @brief 挂接/解除预写日志（nullptr 解除）
+     */
+    void attachJournal(PriceJournal* j);
+    
+    /**
+     * @brief 挂接/解除价格变更流（nullptr 解除）
+     */
+    void attachFeed(PriceChangeFeed* f);
+    
+    /**
+     * @brief 用恢复出的价格整体替换当前内容（不写日志）
+     */
+    void restore(std::map<std::string, double>&& recovered);
 };
 
 /**
@@ -128,7 +231,7 @@ public:
     /**
      * @brief 添加日志（非阻塞）
      */
-    void log(const std::string& message);
+    void log(std::string_view message);
     
     /**
      * @brief 停止日志写入
@@ -147,10 +250,28 @@ private:
     
     // 数据结构
     ThreadSafePriceTable priceTable;
-    std::vector<PriceRecord> priceHistory;
+    
+    // 调价明细：默认完整保留；setHistoryLimit() 设置上限后改为环形缓冲，
+    // 满后覆盖最旧的一条（字符串原地复用容量）
+    std::pmr::unsynchronized_pool_resource historyPool;
+    std::pmr::vector<PriceRecord> priceHistory{&historyPool};
+    size_t historyLimit = 0;  // 0 表示不限
+    size_t historyNext = 0;   // 缓冲已满时下一条覆盖的位置（即最旧的一条）
     
     mutable std::mutex historyMutex;
     
+    // 产品目录（类别、系列、新款标记）
+    ProductCatalog catalog;
+    
+    // 可选：实测价格弹性（由调用方拟合并持有）
+    const ElasticityEstimator* elasticity = nullptr;
+    
+    // 成功调价的压缩时间序列（键为 "商家|产品"，支持区间查询与降采样）
+    PriceSeriesStore priceSeries;
+    
+    // 调价次数最多的 SKU（固定内存，historyMutex 保护）
+    HeavyHitters repriceLeaders{64};
+    
     
     // 日志
     std::unique_ptr<ThreadSafeLogger> logger;
@@ -160,16 +281,37 @@ private:
     std::atomic<int> successTasks;
     std::atomic<int> failedTasks;
     
+    // 是否在控制台打印每条定价结果（大规模压测时关闭）
+    std::atomic<bool> consoleOutput;
+    
     // 任务队列（可选：使用任务队列模式）
     std::queue<PricingTask> taskQueue;
     std::mutex queueMutex;
     std::condition_variable queueCV;
     
+    // 价格预写日志（启用后重启可恢复价格表）
+    std::unique_ptr<PriceJournal> journal;
+    
+    // 价格变更订阅流
+    std::unique_ptr<PriceChangeFeed> changeFeed;
+    
+    // 定时重定价（时间轮调度器，按 SKU 周期向任务队列投递）
+    std::unique_ptr<RepricingScheduler> scheduler;
+    
     /**
      * @brief 商家定价线程函数
      */
     void merchantPricingThread(const Merchant& merchant, pricing::PricingStrategy& strategy);
     
+#ifdef ENABLE_COROUTINE_SIM
+    /**
+     * @brief 商家定价协程（协程模式下替代 merchantPricingThread）
+     */
+    SimTask merchantPricingCoroutine(const Merchant& merchant,
+                                     pricing::PricingStrategy& strategy,
+                                     SimEventLoop& loop);
+#endif
+    
     /**
      * @brief 执行单个定价任务
      */
@@ -183,9 +325,9 @@ private:
     void recordPriceChange(const PricingTask& task, const std::string& merchantName);
     
     /**
-     * @brief 获取当前时间字符串
+     * @brief 把当前时间格式化到 buffer（"YYYY-MM-DD HH:MM:SS"），返回写入长度
      */
-    std::string getCurrentTimeString() const;
+    size_t formatCurrentTime(char* buffer, size_t size) const;
     
     /**
      * @brief 模拟随机延迟（模拟网络延迟）
@@ -208,6 +350,26 @@ public:
      */
     void startPricing(const std::vector<Merchant>& merchants, pricing::PricingStrategy& strategy);
     
+    /**
+     * @brief 协程模式：每个商家是一个协程，由 numThreads 个事件循环线程驱动
+     * 阻塞直到所有商家完成；未启用 ENABLE_COROUTINE_SIM 时退化为线程模式
+     */
+    void runCoroutinePricing(const std::vector<Merchant>& merchants,
+                             pricing::PricingStrategy& strategy,
+                             int numThreads);
+    
+    /**
+     * @brief 开关控制台逐条输出（日志文件不受影响）
+     */
+    void setConsoleOutput(bool enabled) { consoleOutput = enabled; }
+    
+    /**
+     * @brief 只保留最近 limit 条调价明细（0 表示不限，默认不限）
+     * 超出上限时最旧的明细被覆盖，exportPriceTrend() 只导出保留的部分；
+     * 成功调价仍完整保存在 getPriceSeries() 中。
+     */
+    void setHistoryLimit(size_t limit);
+    
     /**
      * @brief 等待所有线程完成
      */
@@ -219,7 +381,7 @@ public:
     void stopAll();
     
     /**
-     * @brief 导出价格趋势CSV
+     * @brief 导出价格趋势CSV（保留的全部明细，按时间顺序）
      */
     void exportPriceTrend(const std::string& filename) const;
     
@@ -242,6 +404,55 @@ public:
      * @brief 任务队列模式：启动工作线程
      */
     void startWorkers(int numWorkers, pricing::PricingStrategy& strategy);
+    
+    /**
+     * @brief 启用价格日志：从目录恢复价格表，之后的价格变更写入 WAL
+     * @return 恢复出的产品数
+     */
+    size_t enableJournal(const std::string& directory);
+    size_t enableJournal(const std::string& directory, const JournalConfig& config);
+    
+    /**
+     * @brief 启用价格变更流，之后可通过 subscribe() 增量消费价格变化
+     */
+    PriceChangeFeed& enableChangeFeed(size_t capacity = 65536);
+    PriceChangeFeed* getChangeFeed() const { return changeFeed.get(); }
+    
+    /**
+     * @brief 价格历史时间序列（只记录成功的调价，每个商家的每个产品一条序列，
+     * 键为 "商家|产品"，与定时重定价的定时器键一致）
+     */
+    const PriceSeriesStore& getPriceSeries() const { return priceSeries; }
+    
+    /**
+     * @brief 成功调价次数最多的 count 个 SKU（流式统计，不排序全部产品）
+     */
+    std::vector<HeavyHitter> getMostRepriced(size_t count = 5) const;
+    
+    /**
+     * @brief 加载产品目录，返回登记的产品数；目录外的产品按 ID 推断
+     */
+    size_t loadCatalog(const std::string& filename) { return catalog.loadFromFile(filename); }
+    ProductCatalog& getCatalog() { return catalog; }
+    
+    /**
+     * @brief 使用实测价格弹性（估计器需基于 getCatalog() 构建，生命周期长于定价过程）
+     */
+    void setElasticityEstimator(const ElasticityEstimator* estimator) { elasticity = estimator; }
+    
+    /**
+     * @brief 定时重定价模式：按 SKU 周期向任务队列投递任务
+     * @param merchants 商家及其负责的产品
+     * @param cadenceOf 返回产品的重定价周期（如热门显卡每分钟、配件每天）
+     * 需配合 startWorkers() 消费任务队列
+     */
+    void startScheduledPricing(const std::vector<Merchant>& merchants,
+                               const std::function<std::chrono::milliseconds(const std::string&)>& cadenceOf);
+    
+    /**
+     * @brief 定时重定价统计（派发、合并、错过截止时间次数）
+     */
+    SchedulerStats getSchedulerStats() const;
 };
 
 #endif // THREAD_MANAGER_H
\ No newline at end of file
@@ -10,6 +10,8 @@
 #include <vector>
 #include <map>
 
+#include "ProductCatalog.h"
+
 // 用于图表的数据点结构
 struct ChartData {
     std::string date;
@@ -24,21 +26,25 @@ public:
      * @brief 生成完整的 HTML 仪表盘并尝试自动打开
      * @param csvPath 输入的 CSV 数据路径
      * @param htmlPath 输出的 HTML 文件路径
+     * @param catalog 产品目录（用于侧边栏图标），为空时按产品 ID 推断
      */
-    static void generateDashboard(const std::string& csvPath, const std::string& htmlPath);
+    static void generateDashboard(const std::string& csvPath, const std::string& htmlPath,
+                                  const ProductCatalog* catalog = nullptr);
 
 private:
     // 解析生成的 CSV
     static std::map<std::string, std::vector<ChartData>> parseCSV(const std::string& filename);
 
     // 构建 HTML 字符串
-    static std::string buildHtml(const std::map<std::string, std::vector<ChartData>>& data);
+    static std::string buildHtml(const std::map<std::string, std::vector<ChartData>>& data,
+                                 const ProductCatalog* catalog);
 
     // 辅助工具：将 C++ 向量转换为 JS 数组字符串
     static std::string vecToString(const std::vector<ChartData>& data, const std::string& field);
 
     // 辅助工具：生成侧边栏产品列表 HTML
-    static std::string generateSidebarHtml(const std::map<std::string, std::vector<ChartData>>& data);
+    static std::string generateSidebarHtml(const std::map<std::string, std::vector<ChartData>>& data,
+                                           const ProductCatalog* catalog);
 };
 
 #endif // VISUALIZER_H
\ No newline at end of file
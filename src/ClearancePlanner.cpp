@@ -0,0 +1,192 @@
+/**
+ * @file ClearancePlanner.cpp
+ * @brief 旧款清仓降价规划实现
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#include "ClearancePlanner.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace {
+
+/**
+ * @brief 可复用的记忆化值表（每线程一份）
+ */
+struct ValueTable {
+    std::vector<double> value;
+    std::vector<uint32_t> stamp;  // 等于 generation 的格子才有效
+    uint32_t generation = 0;
+    size_t stockStates = 0;
+    size_t levels = 0;
+
+    void prepare(size_t days, size_t stocks, size_t levelCount) {
+        stockStates = stocks + 1;
+        levels = levelCount;
+        const size_t cells = (days + 1) * stockStates * levels;
+        if (value.size() < cells) {
+            value.resize(cells);
+            stamp.resize(cells, 0);
+        }
+        if (++generation == 0) {  // 代号回绕：整体作废一次
+            std::fill(stamp.begin(), stamp.end(), 0);
+            generation = 1;
+        }
+    }
+
+    size_t index(int day, int stock, int level) const {
+        return (static_cast<size_t>(day) * stockStates + static_cast<size_t>(stock)) * levels +
+               static_cast<size_t>(level);
+    }
+};
+
+class Solver {
+public:
+    Solver(const ClearanceProblem& problem, const ClearanceConfig& config, ValueTable& table)
+        : problem(problem), config(config), table(table) {
+        days = static_cast<int>(problem.dailyDemand.size());
+        const int stock = std::max(problem.stock, 0);
+        stockStates = std::min(stock, std::max(config.maxStockStates, 1));
+        unit = stockStates > 0 ? static_cast<double>(stock) / stockStates : 1.0;
+
+        for (double level : config.markdownLevels) {
+            const double ratio = 1.0 - level;
+            prices.push_back(problem.basePrice * ratio);
+            lifts.push_back(std::pow(ratio, problem.elasticity));
+        }
+        table.prepare(static_cast<size_t>(days), static_cast<size_t>(stockStates),
+                      config.markdownLevels.size());
+    }
+
+    ClearancePlan extract() {
+        ClearancePlan plan;
+        plan.expectedRevenue = value(0, stockStates, 0);
+
+        // 沿最优策略前推：库存按实际（可为小数）件数递减，动作在该点插值求得
+        double stock = stockStates * unit;
+        int k = 0;
+        for (int t = 0; t < days && stock > 0.0; ++t) {
+            best(t, stock, k, k);
+            plan.markdown.push_back(config.markdownLevels[k]);
+            const double sold = sales(t, stock, k);
+            plan.expectedSold += sold;
+            stock -= sold;
+        }
+        // 售罄后的剩余天数沿用最后一档
+        plan.markdown.resize(days, plan.markdown.empty() ? 0.0 : plan.markdown.back());
+        plan.expectedLeftover = stock;
+        return plan;
+    }
+
+private:
+    const ClearanceProblem& problem;
+    const ClearanceConfig& config;
+    ValueTable& table;
+    int days = 0;
+    int stockStates = 0;
+    double unit = 1.0;
+    std::vector<double> prices;
+    std::vector<double> lifts;
+
+    // 第 t 天在折扣档 k 下的期望销量（件，不取整）
+    double sales(int t, double stock, int k) const {
+        return std::min(stock, std::max(problem.dailyDemand[t], 0.0) * lifts[k]);
+    }
+
+    // 任意库存的值：相邻两个库存格点线性插值
+    double valueAt(int t, double stock, int k) {
+        if (t == days || stock <= 0.0) {
+            return std::max(stock, 0.0) * config.salvageRate * problem.basePrice;
+        }
+        const double g = std::min(stock / unit, static_cast<double>(stockStates));
+        const int lo = static_cast<int>(g);
+        const double frac = g - lo;
+        const double low = value(t, lo, k);
+        return frac > 0.0 ? low + frac * (value(t, lo + 1, k) - low) : low;
+    }
+
+    // 库存为 stock、当前档为 k 时第 t 天的最优值与动作
+    double best(int t, double stock, int k, int& bestLevel) {
+        const double holding = stock * config.holdingCostPerDay;
+        double bestValue = -HUGE_VAL;
+        bestLevel = k;
+        for (int next = k; next < static_cast<int>(prices.size()); ++next) {
+            const double sold = sales(t, stock, next);
+            const double v = prices[next] * sold - holding + valueAt(t + 1, stock - sold, next);
+            if (v > bestValue) {
+                bestValue = v;
+                bestLevel = next;
+            }
+        }
+        return bestValue;
+    }
+
+    // 库存格点 s（即 s × unit 件）上的记忆化值
+    double value(int t, int s, int k) {
+        if (t == days || s == 0) {
+            return s * unit * config.salvageRate * problem.basePrice;
+        }
+        const size_t idx = table.index(t, s, k);
+        if (table.stamp[idx] == table.generation) {
+            return table.value[idx];
+        }
+        int bestLevel;
+        const double v = best(t, s * unit, k, bestLevel);
+        table.value[idx] = v;
+        table.stamp[idx] = table.generation;
+        return v;
+    }
+};
+
+ValueTable& tableForThisThread() {
+    thread_local ValueTable table;
+    return table;
+}
+
+}  // namespace
+
+ClearancePlanner::ClearancePlanner(const ClearanceConfig& config) : config(config) {
+    // 档位升序（动作只能移向更深的档位），最多 256 档
+    auto& levels = this->config.markdownLevels;
+    std::sort(levels.begin(), levels.end());
+    levels.erase(std::unique(levels.begin(), levels.end()), levels.end());
+    if (levels.size() > 256) {
+        levels.resize(256);
+    }
+    if (levels.empty()) {
+        levels.push_back(0.0);
+    }
+}
+
+ClearancePlan ClearancePlanner::plan(const ClearanceProblem& problem) const {
+    Solver solver(problem, config, tableForThisThread());
+    return solver.extract();
+}
+
+std::vector<ClearancePlan> ClearancePlanner::planBatch(const std::vector<ClearanceProblem>& problems,
+                                                       unsigned numThreads) const {
+    std::vector<ClearancePlan> plans(problems.size());
+    if (problems.empty()) {
+        return plans;
+    }
+    if (numThreads == 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    numThreads = static_cast<unsigned>(std::min<size_t>(numThreads, problems.size()));
+
+    // 交错分配：各 SKU 规模差异大时负载更均匀
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < numThreads; ++t) {
+        workers.emplace_back([&, t]() {
+            for (size_t i = t; i < problems.size(); i += numThreads) {
+                plans[i] = plan(problems[i]);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return plans;
+}
@@ -0,0 +1,79 @@
+/**
+ * @file CoroutineSimulator.cpp
+ * @brief 协程事件循环实现
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#include "CoroutineSimulator.h"
+
+#ifdef ENABLE_COROUTINE_SIM
+
+#include <iostream>
+#include <thread>
+
+void SimTask::promise_type::unhandled_exception() noexcept {
+    try {
+        throw;
+    } catch (const std::exception& e) {
+        std::cerr << "[Coroutine] merchant task failed: " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "[Coroutine] merchant task failed with unknown error" << std::endl;
+    }
+}
+
+SimEventLoop::~SimEventLoop() {
+    // 未完成的协程（例如 run() 未被调用）在此统一销毁
+    for (auto h : ready) {
+        h.destroy();
+    }
+    while (!timers.empty()) {
+        timers.top().handle.destroy();
+        timers.pop();
+    }
+}
+
+void SimEventLoop::spawn(SimTask task) {
+    ready.push_back(task.release());
+    live++;
+}
+
+void SimEventLoop::wakeAt(Clock::time_point when, std::coroutine_handle<> h) {
+    timers.push(Timer{when, nextSeq++, h});
+}
+
+void SimEventLoop::resume(std::coroutine_handle<> h) {
+    h.resume();
+    if (h.done()) {
+        h.destroy();
+        live--;
+        completed++;
+    }
+}
+
+void SimEventLoop::run() {
+    std::vector<std::coroutine_handle<>> batch;
+
+    while (live > 0) {
+        // 1. 执行所有就绪协程（恢复过程中可能产生新的定时器）
+        batch.swap(ready);
+        for (auto h : batch) {
+            resume(h);
+        }
+        batch.clear();
+
+        // 2. 取出所有已到期的定时器
+        const auto now = Clock::now();
+        while (!timers.empty() && timers.top().when <= now) {
+            ready.push_back(timers.top().handle);
+            timers.pop();
+        }
+
+        // 3. 无就绪协程时，整个循环只等待一次到最早唤醒点
+        if (ready.empty() && !timers.empty()) {
+            std::this_thread::sleep_until(timers.top().when);
+        }
+    }
+}
+
+#endif // ENABLE_COROUTINE_SIM
@@ -0,0 +1,239 @@
+/**
+ * @file DailyHistory.cpp
+ * @brief 按日历天对齐的稠密销售历史实现
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#include "DailyHistory.h"
+#include "ProductCatalog.h"
+#include "SimSupport.h"
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+// ============================================================================
+// DailySeries
+// ============================================================================
+
+size_t DailySeries::days() const {
+    return isCompressed ? packed.size() : salesByDay.size();
+}
+
+bool DailySeries::inRange(int64_t day) const {
+    return day >= start && day < start + static_cast<int64_t>(salesByDay.size());
+}
+
+void DailySeries::fillForward(size_t from) {
+    // 缺失天沿用前一个观测的价格与库存，直到下一个观测
+    for (size_t i = from; i > 0 && i < salesByDay.size() && !observedByDay[i]; ++i) {
+        priceByDay[i] = priceByDay[i - 1];
+        stockByDay[i] = stockByDay[i - 1];
+    }
+}
+
+void DailySeries::record(int64_t day, double sales, double price, int stock) {
+    if (isCompressed) {
+        *this = expand();
+    }
+    if (salesByDay.empty()) {
+        start = day;
+    } else if (day < start) {
+        // 乱序输入：在前端补齐
+        const size_t shift = static_cast<size_t>(start - day);
+        salesByDay.insert(salesByDay.begin(), shift, 0.0);
+        priceByDay.insert(priceByDay.begin(), shift, 0.0);
+        stockByDay.insert(stockByDay.begin(), shift, 0);
+        observedByDay.insert(observedByDay.begin(), shift, 0);
+        start = day;
+    }
+
+    const size_t index = static_cast<size_t>(day - start);
+    if (index >= salesByDay.size()) {
+        const size_t oldSize = salesByDay.size();
+        salesByDay.resize(index + 1, 0.0);
+        priceByDay.resize(index + 1, 0.0);
+        stockByDay.resize(index + 1, 0);
+        observedByDay.resize(index + 1, 0);
+        fillForward(oldSize);
+    }
+
+    if (observedByDay[index]) {
+        salesByDay[index] += sales;
+    } else {
+        observedByDay[index] = 1;
+        observedCount++;
+        salesByDay[index] = sales;
+    }
+    priceByDay[index] = price;
+    stockByDay[index] = stock;
+    fillForward(index + 1);
+}
+
+bool DailySeries::empty() const {
+    return days() == 0;
+}
+
+int64_t DailySeries::firstDay() const {
+    return start;
+}
+
+int64_t DailySeries::lastDay() const {
+    return start + static_cast<int64_t>(days()) - 1;
+}
+
+size_t DailySeries::length() const {
+    return days();
+}
+
+size_t DailySeries::missingDays() const {
+    return days() - observedCount;
+}
+
+bool DailySeries::observed(int64_t day) const {
+    return inRange(day) && observedByDay[static_cast<size_t>(day - start)];
+}
+
+double DailySeries::sales(int64_t day) const {
+    return inRange(day) ? salesByDay[static_cast<size_t>(day - start)] : 0.0;
+}
+
+double DailySeries::price(int64_t day) const {
+    return inRange(day) ? priceByDay[static_cast<size_t>(day - start)] : 0.0;
+}
+
+int DailySeries::stock(int64_t day) const {
+    return inRange(day) ? stockByDay[static_cast<size_t>(day - start)] : 0;
+}
+
+const std::vector<double>& DailySeries::dailySales() const {
+    return salesByDay;
+}
+
+void DailySeries::compress() {
+    if (isCompressed) {
+        return;
+    }
+    packed = SalesColumns::fromSeries(*this);
+    observedBits.assign(observedByDay.begin(), observedByDay.end());
+    std::vector<double>().swap(salesByDay);
+    std::vector<double>().swap(priceByDay);
+    std::vector<int>().swap(stockByDay);
+    std::vector<uint8_t>().swap(observedByDay);
+    isCompressed = true;
+}
+
+bool DailySeries::compressed() const {
+    return isCompressed;
+}
+
+const SalesColumns& DailySeries::columns() const {
+    return packed;
+}
+
+DailySeries DailySeries::expand() const {
+    if (!isCompressed) {
+        return *this;
+    }
+    // 首尾两天一定有观测：只重放观测天，缺失天由 record() 照常补齐
+    DailySeries dense;
+    int32_t sales[SalesColumns::kBlockSize];
+    int32_t stock[SalesColumns::kBlockSize];
+    double price[SalesColumns::kBlockSize];
+    size_t index = 0;
+    for (size_t b = 0; b < packed.blockCount(); ++b) {
+        const size_t count = packed.decodeSales(b, sales);
+        packed.decodeStock(b, stock);
+        packed.decodePrices(b, price);
+        for (size_t i = 0; i < count; ++i, ++index) {
+            if (observedBits[index]) {
+                dense.record(start + static_cast<int64_t>(index), sales[i], price[i], stock[i]);
+            }
+        }
+    }
+    return dense;
+}
+
+// ============================================================================
+// DailyHistory
+// ============================================================================
+
+size_t DailyHistory::build(const std::vector<Sale>& rows) {
+    // 先解析全部日期；输入不按天有序时按天稳定排序再记录，使每个产品的序列只在尾部增长
+    // （逐条前插对逆序输入是 O(n²)）。同一天的多条记录保持原顺序，价格与库存仍取最后一条。
+    std::vector<int64_t> days(rows.size());
+    std::vector<size_t> order;
+    order.reserve(rows.size());
+    size_t rejected = 0;
+    bool chronological = true;
+    for (size_t i = 0; i < rows.size(); ++i) {
+        if (!parseCivilDate(rows[i].date, days[i])) {
+            rejected++;
+            continue;
+        }
+        chronological = chronological && (order.empty() || days[order.back()] <= days[i]);
+        order.push_back(i);
+    }
+    if (!chronological) {
+        std::stable_sort(order.begin(), order.end(),
+                         [&days](size_t a, size_t b) { return days[a] < days[b]; });
+    }
+
+    DailySeries* current = nullptr;
+    const std::string* lastId = nullptr;
+    for (size_t i : order) {
+        const Sale& sale = rows[i];
+        const int64_t day = days[i];
+        if (!lastId || *lastId != sale.productId) {
+            current = &series[sale.productId];
+            lastId = &sale.productId;
+        }
+        current->record(day, static_cast<double>(sale.sales), sale.price, sale.stock);
+        if (!hasDays) {
+            epoch = latest = day;
+            hasDays = true;
+        }
+        epoch = std::min(epoch, day);
+        latest = std::max(latest, day);
+    }
+
+    if (rejected > 0) {
+        std::cerr << "Warning: skipped " << rejected << " rows with invalid dates" << std::endl;
+    }
+    return order.size();
+}
+
+int64_t DailyHistory::epochDay() const {
+    return epoch;
+}
+
+int64_t DailyHistory::lastDay() const {
+    return latest;
+}
+
+int64_t DailyHistory::offset(int64_t day) const {
+    return day - epoch;
+}
+
+const DailySeries* DailyHistory::find(const std::string& productId) const {
+    auto it = series.find(productId);
+    return it != series.end() ? &it->second : nullptr;
+}
+
+const std::map<std::string, DailySeries>& DailyHistory::products() const {
+    return series;
+}
+
+void DailyHistory::compress() {
+    for (auto& [productId, daily] : series) {
+        daily.compress();
+    }
+}
+
+std::string DailyHistory::formatDay(int64_t day) {
+    int year, month, dayOfMonth;
+    sim::civilFromDays(day, year, month, dayOfMonth);
+    char buffer[16];
+    std::snprintf(buffer, sizeof(buffer), "%04d-%02d-%02d", year, month, dayOfMonth);
+    return buffer;
+}
@@ -1,47 +1,340 @@
 #include "DataLoader.h"
+#include "SalesAnomalyFilter.h"
+#include "DecompressingReader.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <map>
 #include <fstream>
 #include <sstream>
 #include <iostream>
 
+bool LoadFilter::empty() const {
+    return products.empty() && fromDate.empty() && toDate.empty();
+}
+
+bool LoadFilter::matches(std::string_view date, std::string_view productId) const {
+    // 日期为定长 YYYY-MM-DD，字典序即时间顺序
+    if (!fromDate.empty() && date < fromDate) {
+        return false;
+    }
+    if (!toDate.empty() && date > toDate) {
+        return false;
+    }
+    return products.empty() || products.find(productId) != products.end();
+}
+
 DataLoader::DataLoader(const std::string& filename) : filename(filename) {}
 
+void DataLoader::setAnomalyFilter(SalesAnomalyFilter* filter) {
+    anomalyFilter = filter;
+}
+
+bool DataLoader::parseLine(const std::string& line, const LoadFilter& filter, Sale& sale,
+                           bool& malformed) {
+    malformed = false;
+
+    // 解析CSV格式：date,productId,sales,price,stock
+    const size_t dateEnd = line.find(',');
+    const size_t idEnd = dateEnd == std::string::npos ? dateEnd : line.find(',', dateEnd + 1);
+    if (idEnd == std::string::npos) {
+        malformed = !line.empty();
+        return false;
+    }
+    const std::string_view view(line);
+    const std::string_view date = view.substr(0, dateEnd);
+    const std::string_view productId = view.substr(dateEnd + 1, idEnd - dateEnd - 1);
+    if (!filter.matches(date, productId)) {
+        return false;
+    }
+
+    const char* p = line.c_str() + idEnd + 1;
+    char* end = nullptr;
+    const long sales = std::strtol(p, &end, 10);
+    if (end == p || *end != ',') {
+        malformed = true;
+        return false;
+    }
+    p = end + 1;
+    const double price = std::strtod(p, &end);
+    if (end == p || *end != ',') {
+        malformed = true;
+        return false;
+    }
+    p = end + 1;
+    const long stock = std::strtol(p, &end, 10);
+    if (end == p) {
+        malformed = true;
+        return false;
+    }
+
+    sale.date.assign(date);
+    sale.productId.assign(productId);
+    sale.sales = static_cast<int>(sales);
+    sale.price = price;
+    sale.stock = static_cast<int>(stock);
+    sale.flagged = false;
+    return true;
+}
+
 bool DataLoader::loadData() {
-    std::ifstream file(filename);
+    return loadData(LoadFilter{});
+}
+
+bool DataLoader::loadData(const LoadFilter& filter) {
+    std::string line;
+    size_t flaggedCount = 0;
+    size_t malformedCount = 0;
+    const size_t before = salesData.size();
+
+    auto consume = [&](const std::string& text) {
+        Sale sale;
+        bool malformed = false;
+        if (!parseLine(text, filter, sale, malformed)) {
+            malformedCount += malformed;
+            return;
+        }
+        if (anomalyFilter && anomalyFilter->observe(sale, salesData.size())) {
+            flaggedCount++;
+        }
+        salesData.push_back(std::move(sale));
+    };
+
+    // 压缩文件无法按偏移跳转，只能顺序扫描
+    const bool compressed = DecompressingReader::detect(filename) != CompressionFormat::NONE;
+    bool ok = true;
+    std::vector<IndexBlock> blocks;
+    size_t totalBlocks = 0;
+    if (!compressed && !filter.empty() && selectBlocks(filename, filter, blocks, totalBlocks)) {
+        std::ifstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            std::cerr << "Error: Cannot open file " << filename << std::endl;
+            return false;
+        }
+        // 只读取日期范围与产品可能匹配的块
+        for (const IndexBlock& block : blocks) {
+            file.clear();
+            file.seekg(block.offset);
+            for (size_t i = 0; i < block.rows && std::getline(file, line); ++i) {
+                consume(line);
+            }
+        }
+        std::cout << "Index: scanned " << blocks.size() << " of " << totalBlocks << " blocks."
+                  << std::endl;
+    } else {
+        // 顺序扫描；压缩文件由后台线程解压，解析与解压重叠进行
+        DecompressingReader reader;
+        if (!reader.open(filename)) {
+            std::cerr << "Error: Cannot open file " << filename << std::endl;
+            return false;
+        }
+        // 跳过标题行（如果有）
+        reader.getline(line);
+        while (reader.getline(line)) {
+            consume(line);
+        }
+        if (reader.failed()) {
+            std::cerr << "Error: " << filename << " is corrupt or truncated" << std::endl;
+            ok = false;
+        }
+    }
+    
+    std::cout << "Successfully loaded " << salesData.size() - before << " sales records." << std::endl;
+    if (malformedCount > 0) {
+        std::cerr << "Warning: skipped " << malformedCount << " malformed rows." << std::endl;
+    }
+    if (flaggedCount > 0) {
+        std::cout << "Flagged " << flaggedCount << " anomalous sales values." << std::endl;
+    }
+    return ok;
+}
+
+// ============================================================================
+// 稀疏偏移索引
+// 第一行：salesidx,<数据文件字节数>,<每块行数>,<数据文件修改时间>
+// 块：B,<偏移>,<行数>,<最早日期>,<最晚日期>
+// 产品：P,<产品 ID>,<首块>-<末块>,...（连续块合并为区间）
+// ============================================================================
+
+std::string DataLoader::indexPath(const std::string& filename) {
+    return filename + ".idx";
+}
+
+namespace {
+
+// 数据文件的大小与修改时间（文件系统时钟的刻度数）；原地改写但长度不变时靠后者识别
+bool fileStamp(const std::string& filename, unsigned long long& size, long long& mtime) {
+    std::error_code ec;
+    size = std::filesystem::file_size(filename, ec);
+    if (ec) {
+        return false;
+    }
+    const auto written = std::filesystem::last_write_time(filename, ec);
+    mtime = static_cast<long long>(written.time_since_epoch().count());
+    return !ec;
+}
+
+}  // namespace
+
+bool DataLoader::buildIndex(const std::string& filename, size_t blockRows) {
+    if (DecompressingReader::detect(filename) != CompressionFormat::NONE) {
+        std::cerr << "Error: Cannot index compressed file " << filename << std::endl;
+        return false;
+    }
+    std::ifstream file(filename, std::ios::binary);
     if (!file.is_open()) {
         std::cerr << "Error: Cannot open file " << filename << std::endl;
         return false;
     }
+    blockRows = std::max<size_t>(blockRows, 1);
+    // 扫描前取时间戳：扫描期间文件被改写时，索引会在下次检查时判为过期
+    unsigned long long fileSize = 0;
+    long long mtime = 0;
+    if (!fileStamp(filename, fileSize, mtime)) {
+        std::cerr << "Error: Cannot stat file " << filename << std::endl;
+        return false;
+    }
 
+    std::vector<IndexBlock> blocks;
+    // 产品 -> 出现过的块区间 [first, last]
+    std::map<std::string, std::vector<std::pair<size_t, size_t>>, std::less<>> postings;
     std::string line;
-    // 跳过标题行（如果有）
-    std::getline(file, line);
-    
+    std::getline(file, line);  // 标题行
+
+    long long offset = static_cast<long long>(file.tellg());
     while (std::getline(file, line)) {
-        std::stringstream ss(line);
-        Sale sale;
-        std::string token;
-        
-        // 解析CSV格式：date,productId,sales,price,stock
-        std::getline(ss, token, ',');
-        sale.date = token;
-        
-        std::getline(ss, token, ',');
-        sale.productId = token;
-        
-        std::getline(ss, token, ',');
-        sale.sales = std::stoi(token);
-        
-        std::getline(ss, token, ',');
-        sale.price = std::stod(token);
-        
-        std::getline(ss, token, ',');
-        sale.stock = std::stoi(token);
-        
-        salesData.push_back(sale);
+        if (blocks.empty() || blocks.back().rows == blockRows) {
+            blocks.emplace_back();
+            blocks.back().offset = offset;
+        }
+        IndexBlock& block = blocks.back();
+        const size_t blockId = blocks.size() - 1;
+        block.rows++;
+        offset = static_cast<long long>(file.tellg());
+
+        const size_t dateEnd = line.find(',');
+        const size_t idEnd = dateEnd == std::string::npos ? dateEnd : line.find(',', dateEnd + 1);
+        if (idEnd == std::string::npos) {
+            continue;
+        }
+        const std::string_view view(line);
+        const std::string_view date = view.substr(0, dateEnd);
+        if (block.minDate.empty() || date < block.minDate) {
+            block.minDate.assign(date);
+        }
+        if (block.maxDate.empty() || date > block.maxDate) {
+            block.maxDate.assign(date);
+        }
+
+        const std::string_view productId = view.substr(dateEnd + 1, idEnd - dateEnd - 1);
+        auto it = postings.find(productId);
+        if (it == postings.end()) {
+            it = postings.emplace(std::string(productId), std::vector<std::pair<size_t, size_t>>{}).first;
+        }
+        auto& ranges = it->second;
+        if (!ranges.empty() && ranges.back().second + 1 >= blockId) {
+            ranges.back().second = blockId;
+        } else {
+            ranges.emplace_back(blockId, blockId);
+        }
     }
-    
     file.close();
-    std::cout << "Successfully loaded " << salesData.size() << " sales records." << std::endl;
+
+    std::ofstream out(indexPath(filename));
+    if (!out.is_open()) {
+        std::cerr << "Error: Cannot write index " << indexPath(filename) << std::endl;
+        return false;
+    }
+    out << "salesidx," << fileSize << "," << blockRows << "," << mtime << "\n";
+    for (const IndexBlock& block : blocks) {
+        out << "B," << block.offset << "," << block.rows << "," << block.minDate << ","
+            << block.maxDate << "\n";
+    }
+    for (const auto& [productId, ranges] : postings) {
+        out << "P," << productId;
+        for (const auto& [first, last] : ranges) {
+            out << "," << first << "-" << last;
+        }
+        out << "\n";
+    }
+    return static_cast<bool>(out);
+}
+
+bool DataLoader::indexIsCurrent(const std::string& filename) {
+    std::ifstream in(indexPath(filename));
+    std::string header;
+    if (!in.is_open() || !std::getline(in, header)) {
+        return false;
+    }
+    unsigned long long recordedSize = 0;
+    size_t blockRows = 0;
+    long long recordedMtime = 0;
+    unsigned long long actualSize = 0;
+    long long actualMtime = 0;
+    return fileStamp(filename, actualSize, actualMtime) &&
+           std::sscanf(header.c_str(), "salesidx,%llu,%zu,%lld", &recordedSize, &blockRows,
+                       &recordedMtime) == 3 &&
+           recordedSize == actualSize && recordedMtime == actualMtime;
+}
+
+bool DataLoader::selectBlocks(const std::string& filename, const LoadFilter& filter,
+                              std::vector<IndexBlock>& selected, size_t& totalBlocks) {
+    if (!indexIsCurrent(filename)) {
+        return false;
+    }
+    std::ifstream in(indexPath(filename));
+    std::string line;
+    std::getline(in, line);  // 标题行已由 indexIsCurrent 校验
+
+    std::vector<IndexBlock> blocks;
+    std::vector<char> productHit;
+    while (std::getline(in, line)) {
+        if (line.rfind("B,", 0) == 0) {
+            std::stringstream ss(line.substr(2));
+            std::string token;
+            IndexBlock block;
+            std::getline(ss, token, ',');
+            block.offset = std::atoll(token.c_str());
+            std::getline(ss, token, ',');
+            block.rows = static_cast<size_t>(std::atoll(token.c_str()));
+            std::getline(ss, block.minDate, ',');
+            std::getline(ss, block.maxDate, ',');
+            blocks.push_back(std::move(block));
+        } else if (line.rfind("P,", 0) == 0 && !filter.products.empty()) {
+            // 只解析被选中产品的区间
+            const size_t idEnd = line.find(',', 2);
+            const std::string_view productId = std::string_view(line).substr(2, idEnd - 2);
+            if (idEnd == std::string::npos || filter.products.find(productId) == filter.products.end()) {
+                continue;
+            }
+            productHit.resize(blocks.size(), 0);
+            std::stringstream ss(line.substr(idEnd + 1));
+            std::string range;
+            while (std::getline(ss, range, ',')) {
+                size_t first = 0;
+                size_t last = 0;
+                if (std::sscanf(range.c_str(), "%zu-%zu", &first, &last) != 2) {
+                    continue;
+                }
+                for (size_t b = first; b <= last && b < productHit.size(); ++b) {
+                    productHit[b] = 1;
+                }
+            }
+        }
+    }
+
+    totalBlocks = blocks.size();
+    productHit.resize(blocks.size(), 0);
+    for (size_t b = 0; b < blocks.size(); ++b) {
+        const IndexBlock& block = blocks[b];
+        if ((!filter.products.empty() && !productHit[b]) ||
+            (!filter.fromDate.empty() && block.maxDate < filter.fromDate) ||
+            (!filter.toDate.empty() && block.minDate > filter.toDate)) {
+            continue;
+        }
+        selected.push_back(block);
+    }
     return true;
 }
 
@@ -49,6 +342,10 @@ const std::vector<Sale>& DataLoader::getSalesData() const {
     return salesData;
 }
 
+std::vector<Sale> DataLoader::releaseSalesData() {
+    return std::move(salesData);
+}
+
 void DataLoader::displayData() const {
     std::cout << "\n=== Sales Data Preview ===" << std::endl;
     std::cout << "Date\t\tProductID\tSales\tPrice\tStock" << std::endl;
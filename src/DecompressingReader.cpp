@@ -0,0 +1,260 @@
+/**
+ * @file DecompressingReader.cpp
+ * @brief 压缩销售文件的流式读取实现
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#include "DecompressingReader.h"
+#include <cstring>
+#include <iostream>
+
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace {
+
+constexpr size_t kInputChunk = 256 * 1024;
+
+}  // namespace
+
+DecompressingReader::~DecompressingReader() {
+    close();
+}
+
+CompressionFormat DecompressingReader::detect(const std::string& filename) {
+    std::ifstream file(filename, std::ios::binary);
+    unsigned char magic[4] = {0, 0, 0, 0};
+    file.read(reinterpret_cast<char*>(magic), sizeof(magic));
+    const std::streamsize got = file.gcount();
+    if (got >= 2 && magic[0] == 0x1f && magic[1] == 0x8b) {
+        return CompressionFormat::GZIP;
+    }
+    if (got == 4 && magic[0] == 0x28 && magic[1] == 0xb5 && magic[2] == 0x2f && magic[3] == 0xfd) {
+        return CompressionFormat::ZSTD;
+    }
+    return CompressionFormat::NONE;
+}
+
+bool DecompressingReader::open(const std::string& filename) {
+    close();
+    fileFormat = detect(filename);
+
+    if (fileFormat == CompressionFormat::NONE) {
+        plain.open(filename, std::ios::binary);
+        return plain.is_open();
+    }
+#ifndef HAVE_ZLIB
+    if (fileFormat == CompressionFormat::GZIP) {
+        std::cerr << "Error: " << filename << " is gzip-compressed but zlib support is not built in"
+                  << std::endl;
+        return false;
+    }
+#endif
+#ifndef HAVE_ZSTD
+    if (fileFormat == CompressionFormat::ZSTD) {
+        std::cerr << "Error: " << filename << " is zstd-compressed but zstd support is not built in"
+                  << std::endl;
+        return false;
+    }
+#endif
+    if (!std::ifstream(filename, std::ios::binary).is_open()) {
+        return false;
+    }
+
+    for (Buffer& buffer : buffers) {
+        buffer.data.resize(kBufferSize);
+        buffer.size = 0;
+        buffer.ready = false;
+    }
+    finished = error = stopping = false;
+    current = -1;
+    position = 0;
+    nextBuffer = 0;
+    worker = std::thread(&DecompressingReader::decompressLoop, this, filename);
+    return true;
+}
+
+void DecompressingReader::close() {
+    if (worker.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        cv.notify_all();
+        worker.join();
+    }
+    if (plain.is_open()) {
+        plain.close();
+    }
+}
+
+bool DecompressingReader::publish(int index, size_t size) {
+    std::unique_lock<std::mutex> lock(mutex);
+    buffers[index].size = size;
+    buffers[index].ready = true;
+    cv.notify_all();
+    // 等另一个缓冲区被解析线程读完后再继续写
+    cv.wait(lock, [&]() { return !buffers[index ^ 1].ready || stopping; });
+    return !stopping;
+}
+
+void DecompressingReader::decompressLoop(std::string filename) {
+    std::ifstream in(filename, std::ios::binary);
+    std::vector<char> input(kInputChunk);
+    int fill = 0;
+    size_t filled = 0;
+    bool ok = true;
+    bool complete = false;  // 最后一个 gzip 成员 / zstd 帧是否完整结束
+
+    // 当前缓冲区写满时交出并切换到另一个
+    auto flushIfFull = [&]() {
+        if (filled < kBufferSize) {
+            return true;
+        }
+        if (!publish(fill, filled)) {
+            return false;
+        }
+        fill ^= 1;
+        filled = 0;
+        return true;
+    };
+
+#ifdef HAVE_ZLIB
+    if (fileFormat == CompressionFormat::GZIP) {
+        z_stream zs;
+        std::memset(&zs, 0, sizeof(zs));
+        inflateInit2(&zs, 15 + 32);  // 自动识别 gzip 头
+        bool running = true;
+        while (running && ok) {
+            if (zs.avail_in == 0) {
+                in.read(input.data(), static_cast<std::streamsize>(input.size()));
+                const std::streamsize got = in.gcount();
+                if (got <= 0) {
+                    break;
+                }
+                zs.next_in = reinterpret_cast<Bytef*>(input.data());
+                zs.avail_in = static_cast<uInt>(got);
+                if (complete) {
+                    inflateReset(&zs);  // 多个 gzip 成员首尾相接
+                    complete = false;
+                }
+            }
+            zs.next_out = reinterpret_cast<Bytef*>(buffers[fill].data.data() + filled);
+            zs.avail_out = static_cast<uInt>(kBufferSize - filled);
+            const int ret = inflate(&zs, Z_NO_FLUSH);
+            filled = kBufferSize - zs.avail_out;
+            if (ret == Z_STREAM_END) {
+                if (zs.avail_in > 0) {
+                    inflateReset(&zs);
+                } else {
+                    complete = true;
+                }
+            } else if (ret != Z_OK && ret != Z_BUF_ERROR) {
+                ok = false;
+            }
+            running = flushIfFull();
+        }
+        inflateEnd(&zs);
+    }
+#endif
+#ifdef HAVE_ZSTD
+    if (fileFormat == CompressionFormat::ZSTD) {
+        ZSTD_DStream* stream = ZSTD_createDStream();
+        ZSTD_initDStream(stream);
+        ZSTD_inBuffer source = {input.data(), 0, 0};
+        bool running = true;
+        complete = true;
+        while (running && ok) {
+            if (source.pos == source.size) {
+                in.read(input.data(), static_cast<std::streamsize>(input.size()));
+                const std::streamsize got = in.gcount();
+                if (got <= 0) {
+                    break;
+                }
+                source = {input.data(), static_cast<size_t>(got), 0};
+            }
+            ZSTD_outBuffer target = {buffers[fill].data.data(), kBufferSize, filled};
+            const size_t ret = ZSTD_decompressStream(stream, &target, &source);
+            filled = target.pos;
+            if (ZSTD_isError(ret)) {
+                ok = false;
+            }
+            complete = ret == 0;  // 0 表示当前帧已完整解出
+            running = flushIfFull();
+        }
+        ZSTD_freeDStream(stream);
+    }
+#endif
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (stopping) {
+        return;
+    }
+    if (!ok || !complete) {
+        error = true;
+    }
+    if (filled > 0) {
+        // 最后一个缓冲区：此时它一定空闲（flushIfFull 已等待过）
+        buffers[fill].size = filled;
+        buffers[fill].ready = true;
+    }
+    finished = true;
+    cv.notify_all();
+}
+
+bool DecompressingReader::acquire() {
+    std::unique_lock<std::mutex> lock(mutex);
+    if (current >= 0) {
+        buffers[current].ready = false;  // 读完，交还给解压线程
+        current = -1;
+        cv.notify_all();
+    }
+    cv.wait(lock, [&]() { return buffers[nextBuffer].ready || finished; });
+    if (!buffers[nextBuffer].ready) {
+        return false;
+    }
+    current = nextBuffer;
+    nextBuffer ^= 1;
+    position = 0;
+    return true;
+}
+
+bool DecompressingReader::getline(std::string& line) {
+    if (fileFormat == CompressionFormat::NONE) {
+        return static_cast<bool>(std::getline(plain, line));
+    }
+
+    line.clear();
+    for (;;) {
+        if (current < 0 || position == buffers[current].size) {
+            if (!acquire()) {
+                return !line.empty();  // 文件末尾没有换行的最后一行
+            }
+        }
+        const char* begin = buffers[current].data.data() + position;
+        const size_t available = buffers[current].size - position;
+        const void* newline = std::memchr(begin, '\n', available);
+        if (newline) {
+            const size_t length = static_cast<const char*>(newline) - begin;
+            line.append(begin, length);
+            position += length + 1;
+            return true;
+        }
+        line.append(begin, available);
+        position = buffers[current].size;
+    }
+}
+
+bool DecompressingReader::failed() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return error;
+}
+
+CompressionFormat DecompressingReader::format() const {
+    return fileFormat;
+}
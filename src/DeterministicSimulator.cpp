@@ -0,0 +1,381 @@
+/**
+ * @file DeterministicSimulator.cpp
+ * @brief 确定性并行定价模拟实现
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#include "DeterministicSimulator.h"
+#include "PricingStrategy.h"
+#include "SimSupport.h"
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+
+constexpr char kLogMagic[4] = {'D', 'P', 'E', 'L'};
+constexpr uint32_t kLogVersion = 1;
+
+// ---- 二进制编码（显式小端，保证跨平台回放一致） ----
+
+void putU64(std::string& out, uint64_t value, int bytes = 8) {
+    for (int i = 0; i < bytes; ++i) {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+void putVarint(std::string& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+void putDouble(std::string& out, double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    putU64(out, bits);
+}
+
+void putString(std::string& out, const std::string& value) {
+    putVarint(out, value.size());
+    out.append(value);
+}
+
+/**
+ * @brief 顺序读取日志字节，越界时置 ok=false
+ */
+struct LogReader {
+    std::istream& in;
+    bool ok = true;
+
+    uint64_t u64(int bytes = 8) {
+        uint64_t value = 0;
+        for (int i = 0; i < bytes; ++i) {
+            int c = in.get();
+            if (c == EOF) {
+                ok = false;
+                return 0;
+            }
+            value |= static_cast<uint64_t>(c & 0xFF) << (8 * i);
+        }
+        return value;
+    }
+
+    uint64_t varint() {
+        uint64_t value = 0;
+        for (int shift = 0; shift < 64; shift += 7) {
+            int c = in.get();
+            if (c == EOF) {
+                ok = false;
+                return 0;
+            }
+            value |= static_cast<uint64_t>(c & 0x7F) << shift;
+            if ((c & 0x80) == 0) {
+                return value;
+            }
+        }
+        ok = false;
+        return 0;
+    }
+
+    double f64() {
+        uint64_t bits = u64();
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    std::string str() {
+        uint64_t len = varint();
+        std::string value(ok ? len : 0, '\0');
+        if (ok && len > 0 && !in.read(&value[0], static_cast<std::streamsize>(len))) {
+            ok = false;
+        }
+        return value;
+    }
+};
+
+bool sameBits(double a, double b) {
+    return std::memcmp(&a, &b, sizeof(double)) == 0;
+}
+
+}  // namespace
+
+DeterministicSimulator::DeterministicSimulator(const std::vector<Merchant>& merchants,
+                                               pricing::PricingStrategy& strategy,
+                                               ProductCatalog& catalog,
+                                               const DeterministicConfig& config)
+    : merchants(merchants), strategy(strategy), catalog(catalog), config(config) {
+
+    std::unordered_map<std::string, uint32_t> productIndex;
+    for (uint32_t m = 0; m < merchants.size(); ++m) {
+        for (const auto& pid : merchants[m].products) {
+            auto it = productIndex.find(pid);
+            if (it == productIndex.end()) {
+                it = productIndex.emplace(pid, static_cast<uint32_t>(productIds.size())).first;
+                productIds.push_back(pid);
+                productHandles.push_back(catalog.resolve(pid));
+                productInfo.push_back(catalog.info(productHandles.back()));
+            }
+            tasks.push_back({m, it->second});
+        }
+    }
+
+    // 首次定价的基础价格同样由种子决定
+    committed.resize(productIds.size());
+    for (size_t p = 0; p < committed.size(); ++p) {
+        uint64_t rng = sim::mixSeed(this->config.seed, p, UINT64_MAX);
+        committed[p] = sim::uniform(rng, 5000.0, 15000.0);
+    }
+    proposed.resize(tasks.size());
+}
+
+int64_t DeterministicSimulator::logicalDay(int tick) const {
+    const int64_t minutes = static_cast<int64_t>(tick) * config.tickMinutes;
+    return sim::daysFromCivil(config.startYear, config.startMonth, config.startDay) + minutes / 1440;
+}
+
+std::tm DeterministicSimulator::logicalTime(int tick) const {
+    const int64_t minutes = static_cast<int64_t>(tick) * config.tickMinutes;
+    const int64_t days = logicalDay(tick);
+
+    std::tm t{};
+    int year, month, day;
+    sim::civilFromDays(days, year, month, day);
+    t.tm_year = year - 1900;
+    t.tm_mon = month - 1;
+    t.tm_mday = day;
+    t.tm_hour = static_cast<int>((minutes % 1440) / 60);
+    t.tm_min = static_cast<int>(minutes % 60);
+    t.tm_wday = static_cast<int>((days + 4) % 7);  // 1970-01-01 为周四
+    return t;
+}
+
+double DeterministicSimulator::computeTask(size_t taskIndex, int tick) const {
+    const TaskSlot& slot = tasks[taskIndex];
+    const double currentPrice = committed[slot.product];
+    uint64_t rng = sim::mixSeed(config.seed, static_cast<uint64_t>(tick), taskIndex);
+    pricing::ArenaScope arenaScope(pricing::CycleArena::forThisThread());
+
+    // 与 ThreadManager::executePricingTask 相同的输入分布，只是随机源可复现
+    pricing::Product product;
+    product.id = productIds[slot.product];
+    const ProductInfo& meta = productInfo[slot.product];
+    product.name = meta.name;
+    product.category = categoryKey(meta.category);
+    product.basePrice = currentPrice;
+    product.stock = static_cast<int>(sim::uniform(rng, 50.0, 501.0));
+    product.isNewModel = meta.isNewModel;
+    product.series = meta.series;
+
+    pricing::MarketContext context;
+    context.competitorPrice = currentPrice * sim::uniform(rng, 0.85, 1.15);
+    context.demandForecast = sim::uniform(rng, 50.0, 250.0);
+    context.isPeakSeason = sim::uniform(rng, 0.0, 1.0) < 0.3;
+    context.viewCount = static_cast<int>(sim::uniform(rng, 100.0, 2001.0));
+    context.cartCount = static_cast<int>(sim::uniform(rng, 20.0, 401.0));
+    context.purchaseCount = static_cast<int>(sim::uniform(rng, 5.0, 81.0));
+    context.currentTime = logicalTime(tick);
+    context.newerModelInSeriesAvailable =
+        catalog.hasNewerInSeries(productHandles[slot.product], logicalDay(tick));
+
+    return strategy.calculatePrice(product, context).newPrice;
+}
+
+uint64_t DeterministicSimulator::checksumOf(const std::vector<double>& prices) {
+    // FNV-1a over price bit patterns
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (double price : prices) {
+        uint64_t bits;
+        std::memcpy(&bits, &price, sizeof(bits));
+        for (int i = 0; i < 8; ++i) {
+            hash ^= (bits >> (8 * i)) & 0xFF;
+            hash *= 0x100000001B3ULL;
+        }
+    }
+    return hash;
+}
+
+uint64_t DeterministicSimulator::run(ThreadSafePriceTable& table, const std::string& eventLogPath) {
+    std::ofstream log(eventLogPath, std::ios::binary | std::ios::trunc);
+    if (!log.is_open()) {
+        std::cerr << "Error: Cannot create event log " << eventLogPath << std::endl;
+    }
+
+    std::string buffer;
+    buffer.append(kLogMagic, sizeof(kLogMagic));
+    putU64(buffer, kLogVersion, 4);
+    putU64(buffer, config.seed);
+    putVarint(buffer, productIds.size());
+    for (const auto& pid : productIds) {
+        putString(buffer, pid);
+    }
+    putVarint(buffer, merchants.size());
+    for (const auto& merchant : merchants) {
+        putString(buffer, merchant.name);
+    }
+    for (size_t p = 0; p < committed.size(); ++p) {
+        putDouble(buffer, committed[p]);
+        table.setPrice(productIds[p], committed[p]);
+    }
+
+    int numThreads = config.numThreads;
+    if (numThreads <= 0) {
+        numThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    numThreads = static_cast<int>(std::min<size_t>(numThreads, std::max<size_t>(tasks.size(), 1)));
+
+    size_t totalEvents = 0;
+    sim::TickBarrier barrier(numThreads);
+    std::vector<std::thread> workers;
+
+    // 按序提交：屏障完成回调在单个线程上执行，顺序固定为任务序号
+    auto commitTick = [&] {
+        std::string events;
+        size_t eventCount = 0;
+        for (size_t i = 0; i < tasks.size(); ++i) {
+            const TaskSlot& slot = tasks[i];
+            const double newPrice = proposed[i];
+            if (sameBits(newPrice, committed[slot.product])) {
+                continue;
+            }
+            committed[slot.product] = newPrice;
+            table.setPrice(productIds[slot.product], newPrice);
+
+            putVarint(events, slot.merchant);
+            putVarint(events, slot.product);
+            putDouble(events, newPrice);
+            eventCount++;
+        }
+        putVarint(buffer, eventCount + 1);
+        buffer.append(events);
+        totalEvents += eventCount;
+
+        // 按 tick 成组写出
+        if (log.is_open()) {
+            log.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        }
+        buffer.clear();
+    };
+
+    for (int w = 0; w < numThreads; ++w) {
+        const size_t begin = tasks.size() * w / numThreads;
+        const size_t end = tasks.size() * (w + 1) / numThreads;
+
+        workers.emplace_back([this, begin, end, &barrier, &commitTick] {
+            for (int t = 0; t < config.ticks; ++t) {
+                for (size_t i = begin; i < end; ++i) {
+                    proposed[i] = computeTask(i, t);
+                }
+                barrier.arriveAndWait(commitTick);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    const uint64_t checksum = checksumOf(committed);
+    putVarint(buffer, 0);
+    putU64(buffer, checksum);
+    if (log.is_open()) {
+        log.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        log.close();
+    }
+
+    std::cout << "🎲 Deterministic run: seed=" << config.seed << ", " << config.ticks
+              << " ticks, " << totalEvents << " events, checksum=" << std::hex << checksum
+              << std::dec << std::endl;
+    return checksum;
+}
+
+bool DeterministicSimulator::replay(const std::string& eventLogPath, ThreadSafePriceTable& table,
+                                    uint32_t maxTick, uint64_t* checksum) {
+    std::ifstream in(eventLogPath, std::ios::binary);
+    if (!in.is_open()) {
+        std::cerr << "Error: Cannot open event log " << eventLogPath << std::endl;
+        return false;
+    }
+
+    char magic[4];
+    if (!in.read(magic, sizeof(magic)) || std::memcmp(magic, kLogMagic, sizeof(magic)) != 0) {
+        std::cerr << "Error: " << eventLogPath << " is not a pricing event log" << std::endl;
+        return false;
+    }
+
+    LogReader reader{in};
+    if (reader.u64(4) != kLogVersion) {
+        std::cerr << "Error: unsupported event log version" << std::endl;
+        return false;
+    }
+    reader.u64();  // seed
+
+    std::vector<std::string> productIds(reader.ok ? reader.varint() : 0);
+    for (auto& pid : productIds) {
+        pid = reader.str();
+    }
+    const uint64_t merchantCount = reader.varint();
+    for (uint64_t m = 0; m < merchantCount && reader.ok; ++m) {
+        reader.str();
+    }
+
+    std::vector<double> prices(productIds.size());
+    for (auto& price : prices) {
+        price = reader.f64();
+    }
+
+    uint32_t tick = 0;
+    bool complete = false;
+    while (reader.ok) {
+        const uint64_t header = reader.varint();
+        if (!reader.ok) {
+            break;
+        }
+        if (header == 0) {
+            complete = true;
+            break;
+        }
+        for (uint64_t e = 0; e + 1 < header && reader.ok; ++e) {
+            reader.varint();  // merchant
+            const uint64_t product = reader.varint();
+            const double price = reader.f64();
+            if (product >= prices.size()) {
+                reader.ok = false;
+                break;
+            }
+            if (tick < maxTick) {
+                prices[product] = price;
+            }
+        }
+        tick++;
+    }
+
+    if (!reader.ok) {
+        std::cerr << "Error: event log truncated or corrupt at tick " << tick << std::endl;
+        return false;
+    }
+
+    for (size_t p = 0; p < prices.size(); ++p) {
+        table.setPrice(productIds[p], prices[p]);
+    }
+
+    const uint64_t replayed = checksumOf(prices);
+    if (checksum) {
+        *checksum = replayed;
+    }
+    if (complete && maxTick >= tick) {
+        const uint64_t expected = reader.u64();
+        if (!reader.ok || expected != replayed) {
+            std::cerr << "Error: replay checksum mismatch" << std::endl;
+            return false;
+        }
+    }
+
+    std::cout << "⏪ Replayed " << std::min(tick, maxTick) << " ticks from " << eventLogPath
+              << ", checksum=" << std::hex << replayed << std::dec << std::endl;
+    return true;
+}
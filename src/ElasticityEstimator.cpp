@@ -0,0 +1,183 @@
+/**
+ * @file ElasticityEstimator.cpp
+ * @brief 价格弹性估计实现
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#include "ElasticityEstimator.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+
+// 弹性合理区间：正弹性或极端值多为数据噪声
+constexpr double kMinElasticity = -6.0;
+constexpr double kMaxElasticity = 0.0;
+
+}  // namespace
+
+void ElasticityEstimator::Moments::add(double x, double y) {
+    n++;
+    const double dx = x - meanX;
+    meanX += dx / static_cast<double>(n);
+    meanY += (y - meanY) / static_cast<double>(n);
+    cxx += dx * (x - meanX);
+    cxy += dx * (y - meanY);
+}
+
+void ElasticityEstimator::Moments::merge(const Moments& other) {
+    if (other.n == 0) {
+        return;
+    }
+    if (n == 0) {
+        *this = other;
+        return;
+    }
+    const double total = static_cast<double>(n + other.n);
+    const double dx = other.meanX - meanX;
+    const double dy = other.meanY - meanY;
+    const double weight = static_cast<double>(n) * static_cast<double>(other.n) / total;
+    cxx += other.cxx + dx * dx * weight;
+    cxy += other.cxy + dx * dy * weight;
+    meanX += dx * static_cast<double>(other.n) / total;
+    meanY += dy * static_cast<double>(other.n) / total;
+    n += other.n;
+}
+
+ElasticityEstimator::ElasticityEstimator(ProductCatalog& catalog, const ElasticityConfig& config)
+    : catalog(catalog), config(config) {}
+
+size_t ElasticityEstimator::ingest(const std::vector<Sale>& rows, unsigned numThreads) {
+    if (rows.empty()) {
+        return 0;
+    }
+    if (numThreads == 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    // 块边界只取决于行数，与线程数无关：浮点合并顺序固定，拟合结果逐位一致
+    const size_t blockCount = (rows.size() + kIngestBlockRows - 1) / kIngestBlockRows;
+    numThreads = static_cast<unsigned>(std::min<size_t>(numThreads, blockCount));
+
+    // 1. 各线程轮流领取块，块内按产品首次出现的顺序累加
+    struct BlockMoments {
+        std::vector<std::pair<uint32_t, Moments>> products;
+        size_t accepted = 0;
+    };
+    std::vector<BlockMoments> blocks(blockCount);
+    std::atomic<size_t> nextBlock{0};
+    auto worker = [&]() {
+        std::unordered_map<uint32_t, size_t> slot;
+        for (size_t b = nextBlock++; b < blockCount; b = nextBlock++) {
+            BlockMoments& block = blocks[b];
+            const size_t begin = b * kIngestBlockRows;
+            const size_t end = std::min(rows.size(), begin + kIngestBlockRows);
+            slot.clear();
+            const std::string* lastId = nullptr;
+            Moments* current = nullptr;
+            for (size_t i = begin; i < end; ++i) {
+                const Sale& sale = rows[i];
+                if (sale.flagged || sale.sales <= 0 || sale.price <= 0.0) {
+                    continue;
+                }
+                // 同一产品的记录通常连续，复用上一次的句柄查找
+                if (!lastId || *lastId != sale.productId) {
+                    const uint32_t handle = catalog.resolve(sale.productId);
+                    auto [it, inserted] = slot.try_emplace(handle, block.products.size());
+                    if (inserted) {
+                        block.products.emplace_back(handle, Moments{});
+                    }
+                    current = &block.products[it->second].second;
+                    lastId = &sale.productId;
+                }
+                current->add(std::log(sale.price), std::log(static_cast<double>(sale.sales)));
+                block.accepted++;
+            }
+        }
+    };
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < numThreads; ++t) {
+        workers.emplace_back(worker);
+    }
+    worker();
+    for (auto& w : workers) {
+        w.join();
+    }
+
+    // 2. 按块顺序合并；类别和只对变动的 SKU 做差量更新
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    size_t total = 0;
+    for (const BlockMoments& block : blocks) {
+        total += block.accepted;
+        for (const auto& [handle, delta] : block.products) {
+            if (skus.size() <= handle) {
+                const size_t oldSize = skus.size();
+                skus.resize(handle + 1);
+                skuCategory.resize(handle + 1);
+                for (size_t h = oldSize; h <= handle; ++h) {
+                    skuCategory[h] = static_cast<uint8_t>(catalog.info(static_cast<uint32_t>(h)).category);
+                }
+            }
+            Moments& m = skus[handle];
+            CategorySums& sums = categories[skuCategory[handle]];
+            sums.cxx -= m.cxx;
+            sums.cxy -= m.cxy;
+            sums.n -= m.n;
+            m.merge(delta);
+            sums.cxx += m.cxx;
+            sums.cxy += m.cxy;
+            sums.n += m.n;
+        }
+    }
+    return total;
+}
+
+double ElasticityEstimator::categorySlopeLocked(size_t category) const {
+    const CategorySums& sums = categories[category];
+    const double slope = (sums.cxy + config.shrinkage * config.priorElasticity) /
+                         (sums.cxx + config.shrinkage);
+    return std::clamp(slope, kMinElasticity, kMaxElasticity);
+}
+
+ElasticityEstimate ElasticityEstimator::estimateLocked(const Moments& m, size_t category) const {
+    ElasticityEstimate result;
+    result.categoryElasticity = categorySlopeLocked(category);
+    result.observations = m.n;
+    result.skuElasticity = m.cxx > 0.0 ? m.cxy / m.cxx : std::numeric_limits<double>::quiet_NaN();
+    result.skuWeight = m.cxx / (m.cxx + config.shrinkage);
+    result.elasticity = std::clamp(
+        (m.cxy + config.shrinkage * result.categoryElasticity) / (m.cxx + config.shrinkage),
+        kMinElasticity, kMaxElasticity);
+    return result;
+}
+
+ElasticityEstimate ElasticityEstimator::estimate(uint32_t handle) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    if (handle < skus.size()) {
+        return estimateLocked(skus[handle], skuCategory[handle]);
+    }
+    const size_t category = handle != ProductCatalog::kInvalidHandle
+                                ? static_cast<size_t>(catalog.info(handle).category)
+                                : static_cast<size_t>(ProductCategory::GENERAL);
+    return estimateLocked(Moments{}, category);
+}
+
+ElasticityEstimate ElasticityEstimator::estimate(const std::string& productId) const {
+    const uint32_t handle = catalog.find(productId);
+    if (handle != ProductCatalog::kInvalidHandle) {
+        return estimate(handle);
+    }
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return estimateLocked(Moments{},
+                          static_cast<size_t>(ProductCatalog::inferFromId(productId).category));
+}
+
+double ElasticityEstimator::categoryElasticity(ProductCategory category) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return categorySlopeLocked(static_cast<size_t>(category));
+}
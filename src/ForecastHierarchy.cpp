@@ -0,0 +1,226 @@
+/**
+ * @file ForecastHierarchy.cpp
+ * @brief 层级需求预测实现
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#include "ForecastHierarchy.h"
+#include <algorithm>
+#include <mutex>
+#include <thread>
+
+namespace {
+
+// 逐日销量（缺失天为 0）；已压缩的序列按块解码
+void dailyUnits(const DailySeries& daily, std::vector<double>& out) {
+    out.clear();
+    if (!daily.compressed()) {
+        for (double units : daily.dailySales()) {
+            out.push_back(std::max(units, 0.0));
+        }
+        return;
+    }
+    const SalesColumns& columns = daily.columns();
+    out.reserve(columns.size());
+    int32_t block[SalesColumns::kBlockSize];
+    for (size_t b = 0; b < columns.blockCount(); ++b) {
+        const size_t count = columns.decodeSales(b, block);
+        for (size_t i = 0; i < count; ++i) {
+            out.push_back(static_cast<double>(std::max(block[i], 0)));
+        }
+    }
+}
+
+}  // namespace
+
+HorizonForecast NodeForecast::expand(int horizon, int leadTimeDays, double z) const {
+    return Forecaster::expandLevel(dailyDemand, noiseVariance, levelVariance, horizon,
+                                   leadTimeDays, z);
+}
+
+void ForecastHierarchy::SkuState::add(double units, size_t window) {
+    if (ring.size() != window) {
+        ring.assign(window, 0.0);
+    }
+    const size_t slot = static_cast<size_t>(n % window);
+    if (n >= window) {
+        // 与 Forecaster::forecastHorizon 相同：先记录一步残差，再滑动窗口
+        const double residual = units - windowSum / static_cast<double>(window);
+        residualSq += residual * residual;
+        residualCount++;
+        windowSum -= ring[slot];
+    }
+    ring[slot] = units;
+    windowSum += units;
+    n++;
+}
+
+NodeForecast ForecastHierarchy::SkuState::forecast(size_t window) const {
+    NodeForecast node;
+    node.skuCount = 1;
+    if (n == 0) {
+        return node;
+    }
+    const double w = static_cast<double>(std::min<uint64_t>(window, n));
+    const double residualVar =
+        residualCount > 1 ? residualSq / static_cast<double>(residualCount - 1) : 0.0;
+    node.dailyDemand = windowSum / w;
+    node.noiseVariance = residualVar / (1.0 + 1.0 / w);
+    node.levelVariance = node.noiseVariance / w;
+    return node;
+}
+
+ForecastHierarchy::ForecastHierarchy(ProductCatalog& catalog, int window)
+    : catalog(catalog), window(static_cast<size_t>(std::max(window, 1))) {}
+
+void ForecastHierarchy::accumulate(NodeForecast& node, const NodeForecast& delta, double sign) {
+    node.dailyDemand += sign * delta.dailyDemand;
+    node.noiseVariance += sign * delta.noiseVariance;
+    node.levelVariance += sign * delta.levelVariance;
+}
+
+ForecastHierarchy::SkuState& ForecastHierarchy::stateLocked(uint32_t handle) {
+    if (skus.size() <= handle) {
+        skus.resize(handle + 1);
+    }
+    SkuState& state = skus[handle];
+    if (!state.known) {
+        // 首次出现：挂到所属系列与类别下
+        const ProductInfo& info = catalog.info(handle);
+        auto [it, inserted] =
+            seriesIds.emplace(info.series, static_cast<uint32_t>(seriesNodes.size()));
+        if (inserted) {
+            seriesNodes.emplace_back();
+        }
+        state.series = it->second;
+        state.category = static_cast<uint8_t>(info.category);
+        state.known = true;
+        seriesNodes[state.series].skuCount++;
+        categoryNodes[state.category].skuCount++;
+        categoryMembers[state.category].push_back(handle);
+    }
+    return state;
+}
+
+size_t ForecastHierarchy::ingest(const DailyHistory& history, unsigned numThreads) {
+    const auto& products = history.products();
+    if (products.empty()) {
+        return 0;
+    }
+    std::unique_lock<std::shared_mutex> lock(mutex);
+
+    // 1. 先登记所有产品（挂到系列与类别下），逐日销量在各线程里再取
+    std::vector<std::pair<uint32_t, const DailySeries*>> groups;
+    groups.reserve(products.size());
+    size_t days = 0;
+    for (const auto& [productId, daily] : products) {
+        const uint32_t handle = catalog.resolve(productId);
+        stateLocked(handle);
+        groups.emplace_back(handle, &daily);
+        days += daily.length();
+    }
+
+    if (numThreads == 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    numThreads = static_cast<unsigned>(std::min<size_t>(numThreads, groups.size()));
+
+    // 2. 各线程更新自己负责的 SKU，并在本地累加系列 / 类别差量
+    struct LocalDelta {
+        std::vector<NodeForecast> series;
+        std::array<NodeForecast, 5> categories{};
+    };
+    std::vector<LocalDelta> deltas(numThreads);
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < numThreads; ++t) {
+        workers.emplace_back([&, t]() {
+            LocalDelta& local = deltas[t];
+            local.series.resize(seriesNodes.size());
+            std::vector<double> units;
+            for (size_t g = t; g < groups.size(); g += numThreads) {
+                SkuState& state = skus[groups[g].first];
+                const NodeForecast before = state.forecast(window);
+                dailyUnits(*groups[g].second, units);
+                for (double u : units) {
+                    state.add(u, window);
+                }
+                const NodeForecast after = state.forecast(window);
+                accumulate(local.series[state.series], after, 1.0);
+                accumulate(local.series[state.series], before, -1.0);
+                accumulate(local.categories[state.category], after, 1.0);
+                accumulate(local.categories[state.category], before, -1.0);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    // 3. 按线程顺序合并差量
+    for (const LocalDelta& local : deltas) {
+        for (size_t s = 0; s < local.series.size(); ++s) {
+            accumulate(seriesNodes[s], local.series[s], 1.0);
+        }
+        for (size_t c = 0; c < categoryNodes.size(); ++c) {
+            accumulate(categoryNodes[c], local.categories[c], 1.0);
+        }
+    }
+    return days;
+}
+
+void ForecastHierarchy::addSale(uint32_t handle, double units) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    SkuState& state = stateLocked(handle);
+    const NodeForecast before = state.forecast(window);
+    state.add(std::max(units, 0.0), window);
+    const NodeForecast after = state.forecast(window);
+
+    for (NodeForecast* node : {&seriesNodes[state.series], &categoryNodes[state.category]}) {
+        accumulate(*node, before, -1.0);
+        accumulate(*node, after, 1.0);
+    }
+}
+
+NodeForecast ForecastHierarchy::sku(uint32_t handle) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    if (handle >= skus.size() || !skus[handle].known) {
+        return NodeForecast{};
+    }
+    return skus[handle].forecast(window);
+}
+
+NodeForecast ForecastHierarchy::series(const std::string& seriesName) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    auto it = seriesIds.find(seriesName);
+    return it != seriesIds.end() ? seriesNodes[it->second] : NodeForecast{};
+}
+
+NodeForecast ForecastHierarchy::category(ProductCategory category) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return categoryNodes[static_cast<size_t>(category)];
+}
+
+std::vector<std::pair<uint32_t, double>> ForecastHierarchy::allocate(ProductCategory category,
+                                                                     double quantity) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    const std::vector<uint32_t>& members = categoryMembers[static_cast<size_t>(category)];
+    std::vector<std::pair<uint32_t, double>> result;
+    if (members.empty()) {
+        return result;
+    }
+
+    // 份额按 SKU 重新求和，避免增量维护的类别和带来的舍入误差
+    std::vector<double> levels;
+    double total = 0.0;
+    for (uint32_t handle : members) {
+        levels.push_back(skus[handle].forecast(window).dailyDemand);
+        total += levels.back();
+    }
+    for (size_t i = 0; i < members.size(); ++i) {
+        const double share =
+            total > 0.0 ? levels[i] / total : 1.0 / static_cast<double>(members.size());
+        result.emplace_back(members[i], quantity * share);
+    }
+    return result;
+}
@@ -1,4 +1,6 @@
 #include "Forecaster.h"
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <numeric>
 
@@ -34,6 +36,95 @@ double Forecaster::predictNext(const std::vector<double>& history, int window) {
     return sum / window;
 }
 
+HorizonForecast Forecaster::forecastHorizon(const std::vector<double>& history, int horizon,
+                                            int leadTimeDays, int window, double z) {
+    const size_t n = history.size();
+    if (n == 0) {
+        return expandLevel(0.0, 0.0, 0.0, horizon, leadTimeDays, z);
+    }
+    const size_t w = std::min(static_cast<size_t>(std::max(window, 1)), n);
+
+    // 单次遍历：滚动窗口和 + 一步预测残差平方和
+    double windowSum = 0.0;
+    double residualSq = 0.0;
+    size_t residualCount = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (i >= w) {
+            const double residual = history[i] - windowSum / w;
+            residualSq += residual * residual;
+            residualCount++;
+            windowSum -= history[i - w];
+        }
+        windowSum += history[i];
+    }
+
+    // 需求独立同分布时，一步残差方差 = σ²(1 + 1/w)
+    const double residualVar = residualCount > 1 ? residualSq / (residualCount - 1) : 0.0;
+    const double demandVar = residualVar / (1.0 + 1.0 / w);
+    return expandLevel(windowSum / w, demandVar, demandVar / w, horizon, leadTimeDays, z);
+}
+
+HorizonForecast Forecaster::forecastHorizon(const SalesColumns& columns, int horizon,
+                                            int leadTimeDays, int window, double z) {
+    const size_t n = columns.size();
+    if (n == 0) {
+        return expandLevel(0.0, 0.0, 0.0, horizon, leadTimeDays, z);
+    }
+    const size_t w = std::min(static_cast<size_t>(std::max(window, 1)), n);
+
+    // 逐块解码，不展开整列；离开窗口的值可能在上一块，窗口内的值另存环形缓冲
+    std::vector<double> ring(w, 0.0);
+    size_t slot = 0;  // 下一个写入位置（即窗口中最旧的值）
+    size_t seen = 0;
+    double windowSum = 0.0;
+    double residualSq = 0.0;
+    size_t residualCount = 0;
+    int32_t block[SalesColumns::kBlockSize];
+    for (size_t b = 0; b < columns.blockCount(); ++b) {
+        const size_t length = columns.decodeSales(b, block);
+        for (size_t i = 0; i < length; ++i, ++seen) {
+            const double x = static_cast<double>(block[i]);
+            if (seen >= w) {
+                const double residual = x - windowSum / w;
+                residualSq += residual * residual;
+                residualCount++;
+                windowSum -= ring[slot];
+            }
+            ring[slot] = x;
+            windowSum += x;
+            if (++slot == w) {
+                slot = 0;
+            }
+        }
+    }
+
+    const double residualVar = residualCount > 1 ? residualSq / (residualCount - 1) : 0.0;
+    const double demandVar = residualVar / (1.0 + 1.0 / w);
+    return expandLevel(windowSum / w, demandVar, demandVar / w, horizon, leadTimeDays, z);
+}
+
+HorizonForecast Forecaster::expandLevel(double level, double noiseVar, double levelVar,
+                                        int horizon, int leadTimeDays, double z) {
+    HorizonForecast result;
+    horizon = std::max(horizon, 1);
+    leadTimeDays = std::clamp(leadTimeDays, 0, horizon);
+    result.leadTimeDays = leadTimeDays;
+
+    // 移动平均的多步预测为常数水平；单步区间宽度相同
+    const double stepSd = std::sqrt(noiseVar + levelVar);
+    result.mean.assign(horizon, level);
+    result.lower.assign(horizon, std::max(0.0, level - z * stepSd));
+    result.upper.assign(horizon, level + z * stepSd);
+
+    // 累计 L 天：L 天各自的波动 + 水平估计误差（对 L 天完全相关）
+    const double L = static_cast<double>(leadTimeDays);
+    const double cumulativeSd = std::sqrt(L * noiseVar + L * L * levelVar);
+    result.leadTimeDemand = level * L;
+    result.leadTimeLower = std::max(0.0, result.leadTimeDemand - z * cumulativeSd);
+    result.leadTimeUpper = result.leadTimeDemand + z * cumulativeSd;
+    return result;
+}
+
 void Forecaster::displayForecast(const std::vector<double>& history, 
                                 const std::vector<double>& forecast, 
                                 const std::vector<std::string>& dates) {
@@ -0,0 +1,170 @@
+/**
+ * @file HeavyHitters.cpp
+ * @brief 流式 Top-K 实现
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#include "HeavyHitters.h"
+#include "SimSupport.h"
+#include <algorithm>
+#include <functional>
+
+namespace {
+
+// 双重哈希：第 row 行的列号为 h1 + row * h2（h2 取奇数）
+struct SketchHash {
+    uint64_t h1;
+    uint64_t h2;
+
+    explicit SketchHash(const std::string& key) {
+        uint64_t state = std::hash<std::string>{}(key);
+        h1 = sim::nextRandom(state);
+        h2 = sim::nextRandom(state) | 1;
+    }
+
+    size_t column(size_t row, size_t width) const {
+        return static_cast<size_t>((h1 + row * h2) % width);
+    }
+};
+
+}  // namespace
+
+// ============================================================================
+// CountMinSketch
+// ============================================================================
+
+CountMinSketch::CountMinSketch(size_t width, size_t depth)
+    : width(std::max<size_t>(1, width)), depth(std::max<size_t>(1, depth)),
+      counters(this->width * this->depth, 0) {}
+
+void CountMinSketch::add(const std::string& key, uint64_t weight) {
+    const SketchHash hash(key);
+    for (size_t row = 0; row < depth; ++row) {
+        counters[row * width + hash.column(row, width)] += weight;
+    }
+    totalWeight += weight;
+}
+
+uint64_t CountMinSketch::estimate(const std::string& key) const {
+    const SketchHash hash(key);
+    uint64_t best = UINT64_MAX;
+    for (size_t row = 0; row < depth; ++row) {
+        best = std::min(best, counters[row * width + hash.column(row, width)]);
+    }
+    return best;
+}
+
+uint64_t CountMinSketch::total() const {
+    return totalWeight;
+}
+
+void CountMinSketch::clear() {
+    std::fill(counters.begin(), counters.end(), 0);
+    totalWeight = 0;
+}
+
+// ============================================================================
+// HeavyHitters
+// ============================================================================
+
+HeavyHitters::HeavyHitters(size_t capacity)
+    : limit(std::max<size_t>(1, capacity)), sketch(limit * 16, 4) {
+    heap.reserve(limit);
+    slots.reserve(limit);
+}
+
+void HeavyHitters::add(const std::string& key, uint64_t weight) {
+    sketch.add(key, weight);
+
+    auto it = slots.find(key);
+    if (it != slots.end()) {
+        heap[it->second].count += weight;
+        siftDown(it->second);
+        return;
+    }
+
+    if (heap.size() < limit) {
+        // 从未被淘汰过，之前没有出现过该键
+        heap.push_back({key, weight, 0});
+        size_t i = heap.size() - 1;
+        slots.emplace(key, i);
+        while (i > 0 && heap[(i - 1) / 2].count > heap[i].count) {
+            swapSlots(i, (i - 1) / 2);
+            i = (i - 1) / 2;
+        }
+        return;
+    }
+
+    // 替换堆顶：该键此前的频次不超过堆顶计数（堆顶计数单调不减）
+    const uint64_t prior = heap[0].count;
+    slots.erase(heap[0].key);
+    heap[0] = {key, prior + weight, prior};
+    slots.emplace(key, 0);
+    siftDown(0);
+}
+
+void HeavyHitters::siftDown(size_t i) {
+    for (;;) {
+        size_t smallest = i;
+        const size_t left = 2 * i + 1;
+        const size_t right = left + 1;
+        if (left < heap.size() && heap[left].count < heap[smallest].count) {
+            smallest = left;
+        }
+        if (right < heap.size() && heap[right].count < heap[smallest].count) {
+            smallest = right;
+        }
+        if (smallest == i) {
+            return;
+        }
+        swapSlots(i, smallest);
+        i = smallest;
+    }
+}
+
+void HeavyHitters::swapSlots(size_t a, size_t b) {
+    std::swap(heap[a], heap[b]);
+    slots[heap[a].key] = a;
+    slots[heap[b].key] = b;
+}
+
+std::vector<HeavyHitter> HeavyHitters::top(size_t k) const {
+    std::vector<HeavyHitter> result(heap);
+    for (HeavyHitter& h : result) {
+        // 下界 count - error 不变，上界再用草图收紧
+        const uint64_t lower = h.count - h.error;
+        h.count = std::min(h.count, sketch.estimate(h.key));
+        h.error = h.count - lower;
+    }
+    k = std::min(k, result.size());
+    std::partial_sort(result.begin(), result.begin() + k, result.end(),
+                      [](const HeavyHitter& a, const HeavyHitter& b) {
+                          return a.count != b.count ? a.count > b.count : a.key < b.key;
+                      });
+    result.resize(k);
+    return result;
+}
+
+uint64_t HeavyHitters::estimate(const std::string& key) const {
+    auto it = slots.find(key);
+    if (it != slots.end()) {
+        return heap[it->second].count;
+    }
+    // 未满时从未淘汰过，未跟踪即未出现
+    return heap.size() < limit ? 0 : std::min(heap[0].count, sketch.estimate(key));
+}
+
+uint64_t HeavyHitters::total() const {
+    return sketch.total();
+}
+
+size_t HeavyHitters::capacity() const {
+    return limit;
+}
+
+void HeavyHitters::clear() {
+    heap.clear();
+    slots.clear();
+    sketch.clear();
+}
@@ -3,11 +3,12 @@
 #include <fstream>
 #include <algorithm>
 #include <iomanip>
+#include <cmath>
 
 using namespace std;
 
 // Constructor
-InventoryAlert::InventoryAlert() : totalAlerts(0) {
+InventoryAlert::InventoryAlert() : alertLeaders(64), totalAlerts(0) {
     // Initialize with default thresholds if needed
 }
 
@@ -109,6 +110,37 @@ bool InventoryAlert::checkAlert(const string& productID, const string& productNa
         return false;
     }
     
+    return raiseAlert(productID, productName, forecast, currentStock, level, category);
+}
+
+// Lead-time alert check using the cumulative forecast directly
+bool InventoryAlert::checkAlert(const string& productID, const string& productName,
+                                const HorizonForecast& forecast, int currentStock,
+                                ProductCategory category) {
+    if (currentStock <= 0 || forecast.leadTimeDemand <= 0) {
+        return false;
+    }
+
+    // Expected lead-time demand drives the level; the upper bound escalates GREEN
+    // to MEDIUM when stock would not cover demand at the target service level
+    AlertLevel level = getAlertLevel(forecast.leadTimeDemand, currentStock);
+    if (level == AlertLevel::GREEN &&
+        currentStock < calculateThreshold(category, forecast)) {
+        level = AlertLevel::MEDIUM;
+    }
+
+    if (level == AlertLevel::GREEN) {
+        return false;
+    }
+
+    return raiseAlert(productID, productName, forecast.leadTimeDemand, currentStock,
+                      level, category);
+}
+
+// Create, record and print an alert
+bool InventoryAlert::raiseAlert(const string& productID, const string& productName,
+                                double forecast, int currentStock, AlertLevel level,
+                                ProductCategory category) {
     // Create alert record
     AlertRecord alert;
     alert.timestamp = getCurrentTimestamp();
@@ -183,6 +215,16 @@ int InventoryAlert::calculateThreshold(const string& productID,
     return static_cast<int>(baseSafetyStock * multiplier);
 }
 
+// Threshold from the upper bound of forecast lead-time demand
+int InventoryAlert::calculateThreshold(ProductCategory category,
+                                       const HorizonForecast& forecast) const {
+    double multiplier = getCategoryMultiplier(category);
+    if (isPromotionalPeriod()) {
+        multiplier *= 1.3;
+    }
+    return static_cast<int>(std::ceil(forecast.leadTimeUpper * multiplier));
+}
+
 // Set custom threshold for a product
 void InventoryAlert::setProductThreshold(const string& productID, int threshold) {
     lock_guard<mutex> lock(alertMutex);
@@ -205,6 +247,7 @@ void InventoryAlert::recordAlert(const AlertRecord& alert) {
     
     // Update alert count by product
     alertCountByProduct[alert.productID]++;
+    alertLeaders.add(alert.productID);
 }
 
 // Print alert to console with color coding (simplified)
@@ -267,6 +310,12 @@ map<string, int> InventoryAlert::getAlertsByProduct() const {
     return alertCountByProduct;
 }
 
+// Get the most alerted products
+vector<HeavyHitter> InventoryAlert::getTopAlertProducts(size_t count) const {
+    lock_guard<mutex> lock(alertMutex);
+    return alertLeaders.top(count);
+}
+
 // Get all critical alerts
 vector<InventoryAlert::AlertRecord> InventoryAlert::getCriticalAlerts() const {
     return getAlertsByLevel(AlertLevel::CRITICAL);
@@ -296,6 +345,7 @@ void InventoryAlert::clearAlertHistory() {
     lock_guard<mutex> lock(alertMutex);
     alertHistory.clear();
     alertCountByProduct.clear();
+    alertLeaders.clear();
     totalAlerts = 0;
 }
 
@@ -327,20 +377,17 @@ void InventoryAlert::displayAlertSummary() const {
     cout << "  ────────────────────────────────────────────────────────────\n";
     
     // Top products with most alerts
-    if (!alertCountByProduct.empty()) {
+    vector<HeavyHitter> leaders = alertLeaders.top(5);
+    if (!leaders.empty()) {
         cout << "  Top Products by Alert Frequency:\n";
         
-        vector<pair<string, int>> sortedProducts(alertCountByProduct.begin(), 
-                                                 alertCountByProduct.end());
-        sort(sortedProducts.begin(), sortedProducts.end(),
-             [](const pair<string, int>& a, const pair<string, int>& b) {
-                 return a.second > b.second;
-             });
-        
-        int displayCount = min(5, static_cast<int>(sortedProducts.size()));
-        for (int i = 0; i < displayCount; i++) {
-            cout << "    " << (i+1) << ". " << sortedProducts[i].first 
-                 << " (" << sortedProducts[i].second << " alerts)\n";
+        for (size_t i = 0; i < leaders.size(); i++) {
+            cout << "    " << (i+1) << ". " << leaders[i].key 
+                 << " (" << leaders[i].count << " alerts";
+            if (leaders[i].error > 0) {
+                cout << ", over-count <= " << leaders[i].error;
+            }
+            cout << ")\n";
         }
     }
     
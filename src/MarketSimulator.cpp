@@ -0,0 +1,293 @@
+/**
+ * @file MarketSimulator.cpp
+ * @brief 多商家竞争市场模拟实现
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#include "MarketSimulator.h"
+#include "PricingStrategy.h"
+#include "SimSupport.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <thread>
+
+using sim::uniform;
+
+namespace {
+
+constexpr uint64_t kNoPrice = std::numeric_limits<uint64_t>::max();
+
+// 报价键：价格的位模式，低 kOwnerBits 位换成商家编号（相对精度仍约 2^-32）
+constexpr unsigned kOwnerBits = 20;
+constexpr uint64_t kOwnerMask = (uint64_t{1} << kOwnerBits) - 1;
+
+uint64_t quoteKey(double price, size_t merchant) {
+    uint64_t bits;
+    std::memcpy(&bits, &price, sizeof(bits));
+    return (bits & ~kOwnerMask) | (static_cast<uint64_t>(merchant) & kOwnerMask);
+}
+
+double keyToPrice(uint64_t key) {
+    if (key == kNoPrice) {
+        return 0.0;
+    }
+    const uint64_t bits = key & ~kOwnerMask;
+    double price;
+    std::memcpy(&price, &bits, sizeof(price));
+    return price;
+}
+
+// 原子取最小值：只有更低的键才需要 CAS
+void atomicMin(std::atomic<uint64_t>& target, uint64_t key) {
+    uint64_t current = target.load(std::memory_order_relaxed);
+    while (key < current &&
+           !target.compare_exchange_weak(current, key, std::memory_order_relaxed)) {
+    }
+}
+
+}  // namespace
+
+// ============================================================================
+// PriceBook 实现
+// ============================================================================
+
+PriceBook::PriceBook(const std::vector<Merchant>& merchants) {
+    listingOffsets.reserve(merchants.size() + 1);
+    listingOffsets.push_back(0);
+
+    for (const auto& merchant : merchants) {
+        for (const auto& pid : merchant.products) {
+            auto it = productIndex.find(pid);
+            if (it == productIndex.end()) {
+                it = productIndex.emplace(pid, static_cast<uint32_t>(productIds.size())).first;
+                productIds.push_back(pid);
+            }
+            listingProducts.push_back(it->second);
+        }
+        listingOffsets.push_back(listingProducts.size());
+    }
+    listingPrices.assign(listingProducts.size(), 0.0);
+    if (merchants.size() > kOwnerMask) {
+        std::cerr << "Warning: PriceBook supports at most " << kOwnerMask
+                  << " merchants; competitor prices may include a merchant's own quote"
+                  << std::endl;
+    }
+
+    for (auto* keys : {&publishedBest, &pendingBest, &publishedSecond, &pendingSecond}) {
+        *keys = std::make_unique<std::atomic<uint64_t>[]>(productIds.size());
+        for (size_t p = 0; p < productIds.size(); ++p) {
+            (*keys)[p].store(kNoPrice, std::memory_order_relaxed);
+        }
+    }
+}
+
+size_t PriceBook::listingCount(size_t merchant) const {
+    return listingOffsets[merchant + 1] - listingOffsets[merchant];
+}
+
+uint32_t PriceBook::listingProduct(size_t merchant, size_t j) const {
+    return listingProducts[slotIndex(merchant, j)];
+}
+
+double PriceBook::getPrice(size_t merchant, size_t j) const {
+    return listingPrices[slotIndex(merchant, j)];
+}
+
+void PriceBook::postPrice(size_t merchant, size_t j, double price) {
+    const size_t slot = slotIndex(merchant, j);
+    listingPrices[slot] = price;
+
+    // 无锁维护最低价与次低价：没能成为最低价的报价、以及被挤下来的原最低价都进入次低价，
+    // 因此次低价是最低价以外所有报价的最小值（每个商家每个产品一条报价，来自不同商家）
+    const uint32_t product = listingProducts[slot];
+    std::atomic<uint64_t>& best = pendingBest[product];
+    const uint64_t key = quoteKey(price, merchant);
+    uint64_t current = best.load(std::memory_order_relaxed);
+    while (key < current) {
+        if (best.compare_exchange_weak(current, key, std::memory_order_relaxed)) {
+            if (current != kNoPrice) {
+                atomicMin(pendingSecond[product], current);
+            }
+            return;
+        }
+    }
+    atomicMin(pendingSecond[product], key);
+}
+
+double PriceBook::bestPrice(uint32_t product) const {
+    return keyToPrice(publishedBest[product].load(std::memory_order_relaxed));
+}
+
+double PriceBook::competitorPrice(uint32_t product, size_t merchant) const {
+    const uint64_t best = publishedBest[product].load(std::memory_order_relaxed);
+    if (best != kNoPrice && (best & kOwnerMask) == (merchant & kOwnerMask)) {
+        return keyToPrice(publishedSecond[product].load(std::memory_order_relaxed));
+    }
+    return keyToPrice(best);
+}
+
+void PriceBook::publishTick() {
+    for (size_t p = 0; p < productIds.size(); ++p) {
+        publishedBest[p].store(pendingBest[p].load(std::memory_order_relaxed),
+                               std::memory_order_relaxed);
+        publishedSecond[p].store(pendingSecond[p].load(std::memory_order_relaxed),
+                                 std::memory_order_relaxed);
+        pendingBest[p].store(kNoPrice, std::memory_order_relaxed);
+        pendingSecond[p].store(kNoPrice, std::memory_order_relaxed);
+    }
+}
+
+std::map<std::string, double> PriceBook::getBestPrices() const {
+    std::map<std::string, double> result;
+    for (size_t p = 0; p < productIds.size(); ++p) {
+        result[productIds[p]] = bestPrice(static_cast<uint32_t>(p));
+    }
+    return result;
+}
+
+// ============================================================================
+// MarketSimulator 实现
+// ============================================================================
+
+MarketSimulator::MarketSimulator(const std::vector<Merchant>& merchants,
+                                 pricing::PricingStrategy& strategy,
+                                 ProductCatalog& catalog,
+                                 uint32_t seed)
+    : strategy(strategy), seed(seed), book(merchants) {
+
+    // 同一产品所有商家共享建议零售价，初始报价在其附近浮动
+    std::vector<double> msrp(book.productCount());
+    uint64_t rng = seed;
+    for (auto& price : msrp) {
+        price = uniform(rng, 5000.0, 15000.0);
+    }
+
+    productInfo.reserve(book.productCount());
+    for (uint32_t p = 0; p < book.productCount(); ++p) {
+        productInfo.push_back(catalog.info(catalog.resolve(book.productId(p))));
+    }
+
+    listings.resize(book.slotCount());
+    for (size_t m = 0; m < book.merchantCount(); ++m) {
+        for (size_t j = 0; j < book.listingCount(m); ++j) {
+            ListingState& state = listings[book.slotIndex(m, j)];
+            state.listPrice = msrp[book.listingProduct(m, j)];
+            state.stock = static_cast<int>(uniform(rng, 50.0, 500.0));
+            state.demandEstimate = uniform(rng, 5.0, 20.0);
+            book.postPrice(m, j, state.listPrice * uniform(rng, 0.95, 1.05));
+        }
+    }
+    book.publishTick();
+}
+
+void MarketSimulator::simulateMerchant(size_t merchant, int tick) {
+    pricing::ArenaScope arenaScope(pricing::CycleArena::forThisThread());
+    uint64_t rng = (static_cast<uint64_t>(seed) << 32) ^ (merchant * 0x9E3779B97F4A7C15ULL) ^
+                   static_cast<uint64_t>(tick);
+
+    for (size_t j = 0; j < book.listingCount(merchant); ++j) {
+        ListingState& state = listings[book.slotIndex(merchant, j)];
+        const uint32_t productIdx = book.listingProduct(merchant, j);
+        const double best = book.competitorPrice(productIdx, merchant);
+
+        pricing::Product product;
+        const ProductInfo& meta = productInfo[productIdx];
+        product.id = book.productId(productIdx);
+        product.name = meta.name;
+        product.category = categoryKey(meta.category);
+        product.basePrice = state.listPrice;
+        product.stock = state.stock;
+        product.isNewModel = meta.isNewModel;
+        product.series = meta.series;
+
+        // 对手最低价来自共享报价簿（不含自己的报价）；没有其他商家报价时为 0
+        pricing::MarketContext context;
+        context.competitorPrice = best;
+        context.demandForecast = state.demandEstimate;
+        context.viewCount = static_cast<int>(uniform(rng, 100.0, 2000.0));
+        context.cartCount = static_cast<int>(uniform(rng, 20.0, 400.0));
+        context.purchaseCount = static_cast<int>(uniform(rng, 5.0, 80.0));
+        context.currentTime.tm_hour = tick % 24;  // 一个 tick 视为一小时
+
+        const double newPrice = strategy.calculatePrice(product, context).newPrice;
+
+        // 成交量随相对对手最低价的溢价指数衰减
+        const double premium = best > 0.0 ? newPrice / best - 1.0 : 0.0;
+        const double demand = uniform(rng, 5.0, 20.0) * std::exp(-8.0 * std::max(premium, 0.0));
+        const int sold = std::min(state.stock, static_cast<int>(demand));
+        state.stock -= sold;
+        state.demandEstimate = 0.7 * state.demandEstimate + 0.3 * sold;
+        if (state.stock < 20) {
+            state.stock += 200;  // 补货
+        }
+
+        book.postPrice(merchant, j, newPrice);
+    }
+}
+
+void MarketSimulator::run(int ticks, int numThreads) {
+    if (numThreads <= 0) {
+        numThreads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    }
+    const size_t merchantCount = book.merchantCount();
+    numThreads = static_cast<int>(std::min<size_t>(numThreads, std::max<size_t>(merchantCount, 1)));
+
+    std::cout << "\n🏪 Market simulation: " << merchantCount << " merchants, "
+              << book.productCount() << " products, " << ticks << " ticks, "
+              << numThreads << " threads" << std::endl;
+
+    const int firstTick = tickCount;
+    sim::TickBarrier barrier(numThreads);
+    std::vector<std::thread> workers;
+
+    for (int w = 0; w < numThreads; ++w) {
+        const size_t begin = merchantCount * w / numThreads;
+        const size_t end = merchantCount * (w + 1) / numThreads;
+
+        workers.emplace_back([this, begin, end, ticks, firstTick, &barrier] {
+            for (int t = 0; t < ticks; ++t) {
+                for (size_t m = begin; m < end; ++m) {
+                    simulateMerchant(m, firstTick + t);
+                }
+                // 最后到达屏障的线程负责发布本 tick 的最低价
+                barrier.arriveAndWait([this] {
+                    book.publishTick();
+                    std::vector<double> snapshot(book.productCount());
+                    for (size_t p = 0; p < snapshot.size(); ++p) {
+                        snapshot[p] = book.bestPrice(static_cast<uint32_t>(p));
+                    }
+                    bestHistory.push_back(std::move(snapshot));
+                    tickCount++;
+                });
+            }
+        });
+    }
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void MarketSimulator::exportBestPriceTrend(const std::string& filename) const {
+    std::ofstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Cannot create file " << filename << std::endl;
+        return;
+    }
+
+    file << "tick,product,best_price\n";
+    file << std::fixed << std::setprecision(2);
+    for (size_t t = 0; t < bestHistory.size(); ++t) {
+        for (size_t p = 0; p < bestHistory[t].size(); ++p) {
+            file << t << "," << book.productId(static_cast<uint32_t>(p)) << ","
+                 << bestHistory[t][p] << "\n";
+        }
+    }
+
+    file.close();
+    std::cout << "💾 Best price trend exported to: " << filename << std::endl;
+}
@@ -0,0 +1,141 @@
+/**
+ * @file PriceChangeFeed.cpp
+ * @brief 价格变更多播流实现
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#include "PriceChangeFeed.h"
+#include <mutex>
+#include <thread>
+
+PriceChangeFeed::PriceChangeFeed(size_t capacity) {
+    size_t size = 1;
+    while (size < capacity) {
+        size <<= 1;
+    }
+    slots = std::make_unique<Slot[]>(size);
+    mask = size - 1;
+}
+
+void PriceChangeFeed::publish(uint32_t product, double oldPrice, double newPrice,
+                              uint64_t version) {
+    const uint64_t seq = head.fetch_add(1, std::memory_order_acq_rel);
+    Slot& slot = slots[seq & mask];
+
+    // 抢占槽位：若更晚的生产者已写入同一槽位（缓冲绕了一圈），本事件直接作废
+    uint64_t stamp = slot.stamp.load(std::memory_order_relaxed);
+    while (true) {
+        if (stamp & 1) {
+            std::this_thread::yield();
+            stamp = slot.stamp.load(std::memory_order_relaxed);
+            continue;
+        }
+        if (stamp >= 2 * seq + 2) {
+            return;
+        }
+        if (slot.stamp.compare_exchange_weak(stamp, 2 * seq + 1, std::memory_order_acquire)) {
+            break;
+        }
+    }
+
+    slot.product.store(product, std::memory_order_relaxed);
+    slot.oldPrice.store(oldPrice, std::memory_order_relaxed);
+    slot.newPrice.store(newPrice, std::memory_order_relaxed);
+    slot.version.store(version, std::memory_order_relaxed);
+    slot.stamp.store(2 * seq + 2, std::memory_order_release);
+}
+
+uint32_t PriceChangeFeed::intern(const std::string& productId) {
+    {
+        std::shared_lock<std::shared_mutex> lock(namesMutex);
+        auto it = handles.find(productId);
+        if (it != handles.end()) {
+            return it->second;
+        }
+    }
+    std::unique_lock<std::shared_mutex> lock(namesMutex);
+    auto [it, inserted] = handles.try_emplace(productId, static_cast<uint32_t>(names.size()));
+    if (inserted) {
+        names.push_back(productId);
+    }
+    return it->second;
+}
+
+std::string PriceChangeFeed::productName(uint32_t handle) const {
+    std::shared_lock<std::shared_mutex> lock(namesMutex);
+    return handle < names.size() ? names[handle] : std::string();
+}
+
+std::unique_ptr<PriceChangeFeed::Subscription> PriceChangeFeed::subscribe(
+        const std::vector<std::string>& products) {
+    std::vector<bool> filter;
+    for (const auto& productId : products) {
+        const uint32_t handle = intern(productId);
+        if (filter.size() <= handle) {
+            filter.resize(handle + 1, false);
+        }
+        filter[handle] = true;
+    }
+    return std::unique_ptr<Subscription>(
+        new Subscription(*this, head.load(std::memory_order_acquire), std::move(filter)));
+}
+
+// ============================================================================
+// Subscription 实现
+// ============================================================================
+
+PriceChangeFeed::Subscription::Subscription(const PriceChangeFeed& feed, uint64_t start,
+                                            std::vector<bool> filter)
+    : feed(feed), cursor(start), filter(std::move(filter)) {}
+
+uint64_t PriceChangeFeed::Subscription::lag() const {
+    return feed.head.load(std::memory_order_acquire) - cursor;
+}
+
+size_t PriceChangeFeed::Subscription::poll(std::vector<PriceChangeEvent>& out, size_t maxEvents) {
+    const uint64_t capacity = feed.mask + 1;
+    const uint64_t head = feed.head.load(std::memory_order_acquire);
+
+    // 落后超过一圈：跳到最旧的仍在缓冲中的事件
+    if (head - cursor > capacity) {
+        dropped += head - cursor - capacity;
+        cursor = head - capacity;
+    }
+
+    size_t delivered = 0;
+    while (cursor < head && delivered < maxEvents) {
+        const Slot& slot = feed.slots[cursor & feed.mask];
+        const uint64_t expected = 2 * cursor + 2;
+
+        const uint64_t before = slot.stamp.load(std::memory_order_acquire);
+        if (before < expected) {
+            break;  // 生产者已领取序号但尚未写完，下次再读
+        }
+        if (before > expected) {
+            dropped++;  // 读取前已被覆盖
+            cursor++;
+            continue;
+        }
+
+        PriceChangeEvent event;
+        event.sequence = cursor;
+        event.product = slot.product.load(std::memory_order_relaxed);
+        event.oldPrice = slot.oldPrice.load(std::memory_order_relaxed);
+        event.newPrice = slot.newPrice.load(std::memory_order_relaxed);
+        event.version = slot.version.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.stamp.load(std::memory_order_relaxed) != before) {
+            dropped++;  // 读取过程中被覆盖
+            cursor++;
+            continue;
+        }
+
+        cursor++;
+        if (filter.empty() || (event.product < filter.size() && filter[event.product])) {
+            out.push_back(event);
+            delivered++;
+        }
+    }
+    return delivered;
+}
@@ -0,0 +1,458 @@
+/**
+ * @file PriceJournal.cpp
+ * @brief 价格变更预写日志实现
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#include "PriceJournal.h"
+#include "ThreadManager.h"  // ThreadSafePriceTable
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <map>
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace {
+
+constexpr uint32_t kBatchMagic = 0x4C415750;     // "PWAL"
+constexpr char kSnapshotMagic[4] = {'D', 'P', 'S', 'N'};
+constexpr uint32_t kSnapshotVersion = 1;
+constexpr size_t kBatchHeaderSize = 4 + 4 + 4 + 8;
+const char* const kSnapshotFile = "snapshot.bin";
+
+std::string segmentName(uint64_t gen) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "wal-%010llu.log", static_cast<unsigned long long>(gen));
+    return name;
+}
+
+uint64_t fnv1a(const char* data, size_t size) {
+    uint64_t hash = 0xCBF29CE484222325ULL;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= static_cast<unsigned char>(data[i]);
+        hash *= 0x100000001B3ULL;
+    }
+    return hash;
+}
+
+void putFixed(std::string& out, uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+void putRecord(std::string& out, const std::string& key, double price) {
+    size_t len = key.size();
+    while (len >= 0x80) {
+        out.push_back(static_cast<char>((len & 0x7F) | 0x80));
+        len >>= 7;
+    }
+    out.push_back(static_cast<char>(len));
+    out.append(key);
+    uint64_t bits;
+    std::memcpy(&bits, &price, sizeof(bits));
+    putFixed(out, bits, 8);
+}
+
+uint64_t getFixed(const char* p, int bytes) {
+    uint64_t value = 0;
+    for (int i = 0; i < bytes; ++i) {
+        value |= static_cast<uint64_t>(static_cast<unsigned char>(p[i])) << (8 * i);
+    }
+    return value;
+}
+
+/**
+ * @brief 解析一条记录，成功时推进 pos
+ */
+bool getRecord(const std::string& buf, size_t& pos, size_t end, std::string& key, double& price) {
+    uint64_t len = 0;
+    for (int shift = 0;; shift += 7) {
+        if (pos >= end || shift >= 64) {
+            return false;
+        }
+        const unsigned char c = static_cast<unsigned char>(buf[pos++]);
+        len |= static_cast<uint64_t>(c & 0x7F) << shift;
+        if ((c & 0x80) == 0) {
+            break;
+        }
+    }
+    if (end - pos < len + 8) {
+        return false;
+    }
+    key.assign(buf, pos, len);
+    pos += len;
+    const uint64_t bits = getFixed(buf.data() + pos, 8);
+    std::memcpy(&price, &bits, sizeof(price));
+    pos += 8;
+    return true;
+}
+
+bool readWholeFile(const fs::path& path, std::string& out) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+        return false;
+    }
+    out.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
+void syncFile(std::FILE* file) {
+    std::fflush(file);
+#ifndef _WIN32
+    ::fsync(fileno(file));
+#endif
+}
+
+/**
+ * @brief 列出目录中的日志段代号（升序）
+ */
+std::vector<uint64_t> listSegments(const fs::path& dir) {
+    std::vector<uint64_t> gens;
+    std::error_code ec;
+    for (const auto& entry : fs::directory_iterator(dir, ec)) {
+        const std::string name = entry.path().filename().string();
+        if (name.size() > 8 && name.compare(0, 4, "wal-") == 0 &&
+            name.compare(name.size() - 4, 4, ".log") == 0) {
+            gens.push_back(std::stoull(name.substr(4, name.size() - 8)));
+        }
+    }
+    std::sort(gens.begin(), gens.end());
+    return gens;
+}
+
+/**
+ * @brief 读取快照，返回其覆盖的日志段代号（无有效快照返回 0）
+ */
+uint64_t loadSnapshot(const fs::path& path, std::map<std::string, double>& prices) {
+    std::string buf;
+    if (!readWholeFile(path, buf)) {
+        return 0;
+    }
+    const size_t headerSize = 4 + 4 + 8 + 8;
+    if (buf.size() < headerSize + 8 || std::memcmp(buf.data(), kSnapshotMagic, 4) != 0 ||
+        getFixed(buf.data() + 4, 4) != kSnapshotVersion) {
+        std::cerr << "Warning: ignoring invalid snapshot " << path << std::endl;
+        return 0;
+    }
+    const size_t bodyEnd = buf.size() - 8;
+    if (fnv1a(buf.data(), bodyEnd) != getFixed(buf.data() + bodyEnd, 8)) {
+        std::cerr << "Warning: snapshot checksum mismatch, ignoring " << path << std::endl;
+        return 0;
+    }
+
+    const uint64_t covered = getFixed(buf.data() + 8, 8);
+    const uint64_t count = getFixed(buf.data() + 16, 8);
+    size_t pos = headerSize;
+    std::string key;
+    double price;
+    // 快照按键有序写出，带提示插入为均摊 O(1)
+    for (uint64_t i = 0; i < count && getRecord(buf, pos, bodyEnd, key, price); ++i) {
+        prices.emplace_hint(prices.end(), key, price);
+    }
+    return covered;
+}
+
+/**
+ * @brief 只读取快照头部中覆盖的日志段代号
+ */
+uint64_t snapshotGeneration(const fs::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    char header[16];
+    if (!in.read(header, sizeof(header)) || std::memcmp(header, kSnapshotMagic, 4) != 0) {
+        return 0;
+    }
+    return getFixed(header + 8, 8);
+}
+
+/**
+ * @brief 重放一个日志段，遇到残缺或损坏的批次即停止（崩溃时的半写尾部）
+ */
+size_t replaySegment(const fs::path& path, std::map<std::string, double>& prices) {
+    std::string buf;
+    if (!readWholeFile(path, buf)) {
+        return 0;
+    }
+
+    size_t replayed = 0;
+    size_t pos = 0;
+    std::string key;
+    double price;
+    while (buf.size() - pos >= kBatchHeaderSize) {
+        const char* header = buf.data() + pos;
+        const uint64_t payloadSize = getFixed(header + 4, 4);
+        const uint64_t count = getFixed(header + 8, 4);
+        const uint64_t checksum = getFixed(header + 12, 8);
+        const size_t begin = pos + kBatchHeaderSize;
+        if (getFixed(header, 4) != kBatchMagic || buf.size() - begin < payloadSize ||
+            fnv1a(buf.data() + begin, payloadSize) != checksum) {
+            std::cerr << "Warning: discarding torn tail of " << path.filename().string()
+                      << " at offset " << pos << std::endl;
+            break;
+        }
+
+        size_t cursor = begin;
+        const size_t end = begin + payloadSize;
+        for (uint64_t i = 0; i < count && getRecord(buf, cursor, end, key, price); ++i) {
+            prices[key] = price;
+            replayed++;
+        }
+        pos = end;
+    }
+    return replayed;
+}
+
+}  // namespace
+
+// ============================================================================
+// 恢复
+// ============================================================================
+
+size_t PriceJournal::recover(const std::string& directory, ThreadSafePriceTable& table) {
+    const fs::path dir(directory);
+    std::map<std::string, double> prices;
+
+    const uint64_t covered = loadSnapshot(dir / kSnapshotFile, prices);
+    const size_t snapshotEntries = prices.size();
+
+    size_t replayed = 0;
+    for (uint64_t gen : listSegments(dir)) {
+        if (gen > covered) {
+            replayed += replaySegment(dir / segmentName(gen), prices);
+        }
+    }
+
+    if (snapshotEntries > 0 || replayed > 0) {
+        std::cout << "♻️  Recovered " << prices.size() << " prices (snapshot " << snapshotEntries
+                  << ", replayed " << replayed << " journal records)" << std::endl;
+    }
+    table.restore(std::move(prices));
+    return replayed;
+}
+
+// ============================================================================
+// 写入
+// ============================================================================
+
+PriceJournal::PriceJournal(const std::string& directory, ThreadSafePriceTable& table,
+                           const JournalConfig& config)
+    : directory(directory), table(table), config(config), stopFlag(false) {
+
+    std::error_code ec;
+    fs::create_directories(directory, ec);
+
+    recoveredRecords = recover(directory, table);
+
+    // 新段代号必须大于已有的段，保证按代号排序即为写入顺序
+    std::vector<uint64_t> gens = listSegments(directory);
+    uint64_t lastGen = snapshotGeneration(fs::path(directory) / kSnapshotFile);
+    if (!gens.empty()) {
+        lastGen = std::max(lastGen, gens.back());
+    }
+    openSegment(lastGen + 1);
+
+    table.attachJournal(this);
+    writerThread = std::thread(&PriceJournal::writerThreadFunc, this);
+
+    if (config.snapshotEveryRecords > 0) {
+        snapshotThread = std::thread([this] {
+            std::unique_lock<std::mutex> lock(journalMutex);
+            while (true) {
+                writerCV.wait(lock, [this] {
+                    return stopFlag.load() ||
+                           recordsSinceSnapshot >= this->config.snapshotEveryRecords;
+                });
+                if (stopFlag) {
+                    break;
+                }
+                recordsSinceSnapshot = 0;
+                lock.unlock();
+                checkpoint();
+                lock.lock();
+            }
+        });
+    }
+}
+
+PriceJournal::~PriceJournal() {
+    table.attachJournal(nullptr);  // 等待进行中的写入完成后不再追加
+
+    {
+        std::lock_guard<std::mutex> lock(journalMutex);
+        stopFlag = true;
+    }
+    writerCV.notify_all();
+    if (snapshotThread.joinable()) {
+        snapshotThread.join();
+    }
+    if (writerThread.joinable()) {
+        writerThread.join();
+    }
+    if (segment) {
+        std::fclose(segment);
+    }
+}
+
+std::string PriceJournal::segmentPath(uint64_t gen) const {
+    return (fs::path(directory) / segmentName(gen)).string();
+}
+
+void PriceJournal::openSegment(uint64_t gen) {
+    generation = gen;
+    segment = std::fopen(segmentPath(gen).c_str(), "ab");
+    if (!segment) {
+        std::cerr << "Error: Cannot open journal segment " << segmentPath(gen) << std::endl;
+    }
+}
+
+uint64_t PriceJournal::append(const std::string& productId, double price) {
+    bool wake;
+    uint64_t lsn;
+    {
+        std::lock_guard<std::mutex> lock(journalMutex);
+        // 缓冲由空变非空时唤醒写线程；写盘期间到达的记录自然并入下一批
+        wake = pendingCount == 0 || (config.snapshotEveryRecords > 0 &&
+                                     recordsSinceSnapshot + 1 == config.snapshotEveryRecords);
+        putRecord(pending, productId, price);
+        pendingCount++;
+        recordsSinceSnapshot++;
+        lsn = nextLsn++;
+    }
+    if (wake) {
+        writerCV.notify_all();
+    }
+    return lsn;
+}
+
+void PriceJournal::waitDurable(uint64_t lsn) {
+    std::unique_lock<std::mutex> lock(journalMutex);
+    writerCV.notify_all();
+    durableCV.wait(lock, [this, lsn] { return durableLsn >= lsn || stopFlag.load(); });
+}
+
+void PriceJournal::flush() {
+    uint64_t lsn;
+    {
+        std::lock_guard<std::mutex> lock(journalMutex);
+        lsn = nextLsn - 1;
+    }
+    waitDurable(lsn);
+}
+
+void PriceJournal::writerThreadFunc() {
+    std::string batch;
+    std::unique_lock<std::mutex> lock(journalMutex);
+
+    while (true) {
+        writerCV.wait_for(lock, std::chrono::milliseconds(config.groupCommitMs), [this] {
+            return pendingCount > 0 || rotateRequested || stopFlag.load();
+        });
+        if (stopFlag && pendingCount == 0 && !rotateRequested) {
+            break;
+        }
+
+        batch.clear();
+        batch.swap(pending);
+        const uint32_t count = pendingCount;
+        const uint64_t lastLsn = nextLsn - 1;
+        pendingCount = 0;
+        const bool rotate = rotateRequested;
+        lock.unlock();
+
+        // 组提交：一批记录一个头部、一次写入、一次 fsync
+        if (count > 0 && segment) {
+            std::string header;
+            putFixed(header, kBatchMagic, 4);
+            putFixed(header, batch.size(), 4);
+            putFixed(header, count, 4);
+            putFixed(header, fnv1a(batch.data(), batch.size()), 8);
+            std::fwrite(header.data(), 1, header.size(), segment);
+            std::fwrite(batch.data(), 1, batch.size(), segment);
+            if (config.syncToDisk) {
+                syncFile(segment);
+            } else {
+                std::fflush(segment);
+            }
+        }
+
+        if (rotate && segment) {
+            std::fclose(segment);
+            segment = nullptr;
+            const uint64_t oldGen = generation;
+            openSegment(oldGen + 1);
+            lock.lock();
+            rotatedGeneration = oldGen;
+            rotateRequested = false;
+        } else {
+            lock.lock();
+        }
+        durableLsn = std::max(durableLsn, lastLsn);
+        durableCV.notify_all();
+    }
+}
+
+void PriceJournal::checkpoint() {
+    std::lock_guard<std::mutex> snapshotLock(snapshotMutex);
+
+    uint64_t covered;
+    {
+        std::unique_lock<std::mutex> lock(journalMutex);
+        rotateRequested = true;
+        writerCV.notify_all();
+        durableCV.wait(lock, [this] { return !rotateRequested || stopFlag.load(); });
+        if (rotateRequested) {
+            return;  // 正在关闭，写线程已退出
+        }
+        covered = rotatedGeneration;
+    }
+    // 切段之后再读价格表：旧段中的所有修改都已进入价格表
+    writeSnapshot(covered);
+}
+
+void PriceJournal::writeSnapshot(uint64_t coveredGeneration) {
+    const std::map<std::string, double> prices = table.getAllPrices();
+
+    std::string buf;
+    buf.reserve(prices.size() * 24 + 32);
+    buf.append(kSnapshotMagic, sizeof(kSnapshotMagic));
+    putFixed(buf, kSnapshotVersion, 4);
+    putFixed(buf, coveredGeneration, 8);
+    putFixed(buf, prices.size(), 8);
+    for (const auto& [productId, price] : prices) {
+        putRecord(buf, productId, price);
+    }
+    putFixed(buf, fnv1a(buf.data(), buf.size()), 8);
+
+    const fs::path dir(directory);
+    const fs::path tmpPath = dir / "snapshot.bin.tmp";
+    std::FILE* file = std::fopen(tmpPath.string().c_str(), "wb");
+    if (!file) {
+        std::cerr << "Error: Cannot write snapshot " << tmpPath << std::endl;
+        return;
+    }
+    std::fwrite(buf.data(), 1, buf.size(), file);
+    syncFile(file);
+    std::fclose(file);
+
+    // 原子替换后才删除被覆盖的日志段
+    std::error_code ec;
+    fs::rename(tmpPath, dir / kSnapshotFile, ec);
+    if (ec) {
+        std::cerr << "Error: Cannot install snapshot: " << ec.message() << std::endl;
+        return;
+    }
+    for (uint64_t gen : listSegments(dir)) {
+        if (gen <= coveredGeneration) {
+            fs::remove(segmentPath(gen), ec);
+        }
+    }
+}
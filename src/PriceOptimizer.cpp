@@ -0,0 +1,193 @@
+/**
+ * @file PriceOptimizer.cpp
+ * @brief 收益 / 毛利最优定价求解实现
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#include "PriceOptimizer.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+namespace {
+
+constexpr int kGridPoints = 24;
+constexpr int kGoldenIterations = 28;  // 区间缩小到格距的 0.618^28 ≈ 1.4e-6
+constexpr double kInvPhi = 0.6180339887498949;
+
+// 每个线程一次处理的 SKU 数：结构化数组放得进 L1/L2
+constexpr size_t kBlockSize = 1024;
+
+}  // namespace
+
+PriceOptimizer::PriceOptimizer(PriceObjective objective, const OptimizerConstraints& constraints)
+    : objective(objective), constraints(constraints) {}
+
+void PriceOptimizer::priceBounds(const PriceProblem& problem, double& lower, double& upper) const {
+    const double base = std::max(problem.basePrice, 1e-9);
+    upper = base * constraints.maxMultiplier;
+    lower = base * constraints.minMultiplier;
+    if (problem.competitorPrice > 0.0) {
+        upper = std::min(upper, problem.competitorPrice * (1.0 + constraints.maxCompetitorPremium));
+    }
+    upper = std::max(upper, lower);  // 竞品价低于下限时以下限为准（同 clampPrice）
+}
+
+PriceSolution PriceOptimizer::solveRevenue(const PriceProblem& p) const {
+    double lower, upper;
+    priceBounds(p, lower, upper);
+    const double base = std::max(p.basePrice, 1e-9);
+    const double stock = std::max(p.stock, 0);
+
+    PriceSolution s;
+    if (stock <= 0.0 || p.referenceDemand <= 0.0) {
+        // 无库存或无需求：目标恒为 0，保持参考价（落在约束区间内）
+        s.price = std::clamp(base, lower, upper);
+        return s;
+    }
+    // 收益 p × min(q(p), S)：库存约束外正比于 p^(1+e)。e < -1 时随价格下降而增大，
+    // 最优为恰好售完库存的价格 p0 (S / q0)^(1/e)；否则收益随价格单调不减，取上限
+    s.price = p.elasticity < -1.0
+                  ? std::clamp(base * std::pow(stock / p.referenceDemand, 1.0 / p.elasticity),
+                               lower, upper)
+                  : upper;
+    s.expectedUnits = std::min(p.referenceDemand * std::pow(s.price / base, p.elasticity), stock);
+    s.objective = s.price * s.expectedUnits;
+    return s;
+}
+
+PriceSolution PriceOptimizer::solve(const PriceProblem& problem) const {
+    PriceSolution solution;
+    solveRange(&problem, &solution, 1);
+    return solution;
+}
+
+std::vector<PriceSolution> PriceOptimizer::solveBatch(const std::vector<PriceProblem>& problems,
+                                                      unsigned numThreads) const {
+    std::vector<PriceSolution> solutions(problems.size());
+    if (problems.empty()) {
+        return solutions;
+    }
+    if (numThreads == 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    const size_t blocks = (problems.size() + kBlockSize - 1) / kBlockSize;
+    numThreads = static_cast<unsigned>(std::min<size_t>(numThreads, blocks));
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < numThreads; ++t) {
+        workers.emplace_back([&, t]() {
+            for (size_t b = t; b < blocks; b += numThreads) {
+                const size_t begin = b * kBlockSize;
+                const size_t count = std::min(kBlockSize, problems.size() - begin);
+                solveRange(problems.data() + begin, solutions.data() + begin, count);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    return solutions;
+}
+
+void PriceOptimizer::solveRange(const PriceProblem* problems, PriceSolution* out,
+                                size_t count) const {
+    if (objective == PriceObjective::REVENUE) {
+        for (size_t i = 0; i < count; ++i) {
+            out[i] = solveRevenue(problems[i]);
+        }
+        return;
+    }
+
+    // 结构化数组：log 价格搜索区间与需求曲线参数
+    std::vector<double> lo(count), hi(count), logBase(count), logDemand(count);
+    std::vector<double> elasticity(count), stock(count), cost(count);
+    std::vector<double> bestU(count), bestF(count);
+
+    for (size_t i = 0; i < count; ++i) {
+        const PriceProblem& p = problems[i];
+        const double base = std::max(p.basePrice, 1e-9);
+        double lower, upper;
+        priceBounds(p, lower, upper);
+
+        lo[i] = std::log(lower);
+        hi[i] = std::log(upper);
+        logBase[i] = std::log(base);
+        logDemand[i] = std::log(std::max(p.referenceDemand, 1e-12));
+        elasticity[i] = p.elasticity;
+        stock[i] = std::max(p.stock, 0);
+        cost[i] = p.unitCost;
+        bestU[i] = lo[i];
+        bestF[i] = -HUGE_VAL;
+    }
+
+    // 毛利目标：(p - c) × min(q(p), stock)
+    auto evaluate = [&](size_t i, double u) {
+        const double price = std::exp(u);
+        const double demand = std::exp(logDemand[i] + elasticity[i] * (u - logBase[i]));
+        return (price - cost[i]) * std::min(demand, stock[i]);
+    };
+
+    // 1. 网格粗搜
+    for (int g = 0; g < kGridPoints; ++g) {
+        const double t = static_cast<double>(g) / (kGridPoints - 1);
+        for (size_t i = 0; i < count; ++i) {
+            const double u = lo[i] + t * (hi[i] - lo[i]);
+            const double f = evaluate(i, u);
+            if (f > bestF[i]) {
+                bestF[i] = f;
+                bestU[i] = u;
+            }
+        }
+    }
+
+    // 2. 在最优格点两侧各一格内做黄金分割
+    std::vector<double> a(count), b(count), c(count), d(count), fc(count), fd(count);
+    for (size_t i = 0; i < count; ++i) {
+        const double step = (hi[i] - lo[i]) / (kGridPoints - 1);
+        a[i] = std::max(lo[i], bestU[i] - step);
+        b[i] = std::min(hi[i], bestU[i] + step);
+        c[i] = b[i] - kInvPhi * (b[i] - a[i]);
+        d[i] = a[i] + kInvPhi * (b[i] - a[i]);
+        fc[i] = evaluate(i, c[i]);
+        fd[i] = evaluate(i, d[i]);
+    }
+    for (int iter = 0; iter < kGoldenIterations; ++iter) {
+        for (size_t i = 0; i < count; ++i) {
+            if (fc[i] >= fd[i]) {
+                b[i] = d[i];
+                d[i] = c[i];
+                fd[i] = fc[i];
+                c[i] = b[i] - kInvPhi * (b[i] - a[i]);
+                fc[i] = evaluate(i, c[i]);
+            } else {
+                a[i] = c[i];
+                c[i] = d[i];
+                fc[i] = fd[i];
+                d[i] = a[i] + kInvPhi * (b[i] - a[i]);
+                fd[i] = evaluate(i, d[i]);
+            }
+        }
+    }
+
+    // 3. 细化结果不优于格点时保留格点（目标在区间内非单峰时的保护）
+    for (size_t i = 0; i < count; ++i) {
+        const double u = fc[i] >= fd[i] ? c[i] : d[i];
+        const double f = std::max(fc[i], fd[i]);
+        const double chosen = f > bestF[i] ? u : bestU[i];
+
+        PriceSolution& s = out[i];
+        if (stock[i] <= 0.0 || problems[i].referenceDemand <= 0.0) {
+            // 无库存或无需求：目标恒为 0，保持参考价（落在约束区间内）
+            s.price = std::clamp(std::exp(logBase[i]), std::exp(lo[i]), std::exp(hi[i]));
+            s.expectedUnits = 0.0;
+            s.objective = 0.0;
+            continue;
+        }
+        s.price = std::exp(chosen);
+        s.expectedUnits = std::min(
+            std::exp(logDemand[i] + elasticity[i] * (chosen - logBase[i])), stock[i]);
+        s.objective = (s.price - cost[i]) * s.expectedUnits;
+    }
+}
@@ -0,0 +1,359 @@
+/**
+ * @file PriceSeriesStore.cpp
+ * @brief Gorilla 压缩价格时间序列实现
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#include "PriceSeriesStore.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+int countLeadingZeros(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return x == 0 ? 64 : __builtin_clzll(x);
+#else
+    int n = 0;
+    for (uint64_t mask = 1ULL << 63; mask && !(x & mask); mask >>= 1) {
+        n++;
+    }
+    return n;
+#endif
+}
+
+int countTrailingZeros(uint64_t x) {
+#if defined(__GNUC__) || defined(__clang__)
+    return x == 0 ? 64 : __builtin_ctzll(x);
+#else
+    int n = 0;
+    for (uint64_t mask = 1; mask && !(x & mask); mask <<= 1) {
+        n++;
+    }
+    return n;
+#endif
+}
+
+uint64_t doubleToBits(double value) {
+    uint64_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+double bitsToDouble(uint64_t bits) {
+    double value;
+    std::memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// 向下取整除法（负时间戳也能正确对齐分桶）
+int64_t floorDiv(int64_t a, int64_t b) {
+    int64_t q = a / b;
+    return (a % b != 0 && ((a < 0) != (b < 0))) ? q - 1 : q;
+}
+
+}  // namespace
+
+// ============================================================================
+// GorillaBlock 实现
+// ============================================================================
+
+void GorillaBlock::writeBits(uint64_t value, int bits) {
+    // 高位优先写入 64 位字
+    while (bits > 0) {
+        const uint32_t offset = static_cast<uint32_t>(bitCount & 63);
+        if (offset == 0) {
+            words.push_back(0);
+        }
+        const int room = 64 - static_cast<int>(offset);
+        const int take = std::min(room, bits);
+        const uint64_t chunk = (bits == 64 && take == 64)
+                                   ? value
+                                   : (value >> (bits - take)) & ((1ULL << take) - 1);
+        words.back() |= (take == 64) ? chunk : chunk << (room - take);
+        bitCount += take;
+        bits -= take;
+    }
+}
+
+void GorillaBlock::append(int64_t timestamp, double price) {
+    const uint64_t bits = doubleToBits(price);
+
+    if (count == 0) {
+        firstTs = timestamp;
+        prevTs = timestamp;
+        prevDelta = 0;
+        writeBits(bits, 64);
+        prevBits = bits;
+        count = 1;
+        return;
+    }
+
+    // ---- 时间戳：二阶差分 ----
+    const int64_t delta = timestamp - prevTs;
+    const int64_t dod = delta - prevDelta;
+    if (dod == 0) {
+        writeBits(0, 1);
+    } else if (dod >= -63 && dod <= 64) {
+        writeBits(0b10, 2);
+        writeBits(static_cast<uint64_t>(dod + 63), 7);
+    } else if (dod >= -255 && dod <= 256) {
+        writeBits(0b110, 3);
+        writeBits(static_cast<uint64_t>(dod + 255), 9);
+    } else if (dod >= -2047 && dod <= 2048) {
+        writeBits(0b1110, 4);
+        writeBits(static_cast<uint64_t>(dod + 2047), 12);
+    } else {
+        writeBits(0b1111, 4);
+        writeBits(static_cast<uint64_t>(dod), 64);
+    }
+    prevDelta = delta;
+    prevTs = timestamp;
+
+    // ---- 价格：XOR ----
+    const uint64_t x = bits ^ prevBits;
+    if (x == 0) {
+        writeBits(0, 1);
+    } else {
+        writeBits(1, 1);
+        const int leading = std::min(countLeadingZeros(x), 31);
+        const int trailing = countTrailingZeros(x);
+        if (prevLeading != 0xFF && leading >= prevLeading && trailing >= prevTrailing) {
+            // 有效位落在上一个窗口内，复用窗口
+            writeBits(0, 1);
+            const int meaningful = 64 - prevLeading - prevTrailing;
+            writeBits(x >> prevTrailing, meaningful);
+        } else {
+            const int meaningful = 64 - leading - trailing;
+            writeBits(1, 1);
+            writeBits(static_cast<uint64_t>(leading), 5);
+            writeBits(static_cast<uint64_t>(meaningful & 63), 6);  // 64 编码为 0
+            writeBits(x >> trailing, meaningful);
+            prevLeading = static_cast<uint8_t>(leading);
+            prevTrailing = static_cast<uint8_t>(trailing);
+        }
+    }
+    prevBits = bits;
+    count++;
+}
+
+// ============================================================================
+// GorillaReader 实现
+// ============================================================================
+
+uint64_t GorillaReader::readBits(int n) {
+    uint64_t value = 0;
+    while (n > 0) {
+        const uint64_t word = block.words[bitPos >> 6];
+        const int offset = static_cast<int>(bitPos & 63);
+        const int room = 64 - offset;
+        const int take = std::min(room, n);
+        const uint64_t chunk = (take == 64) ? word : (word >> (room - take)) & ((1ULL << take) - 1);
+        value = (take == 64) ? chunk : (value << take) | chunk;
+        bitPos += take;
+        n -= take;
+    }
+    return value;
+}
+
+bool GorillaReader::next(int64_t& timestamp, double& price) {
+    if (index >= block.count) {
+        return false;
+    }
+
+    if (index == 0) {
+        ts = block.firstTs;
+        delta = 0;
+        bits = readBits(64);
+    } else {
+        int64_t dod;
+        if (readBits(1) == 0) {
+            dod = 0;
+        } else if (readBits(1) == 0) {
+            dod = static_cast<int64_t>(readBits(7)) - 63;
+        } else if (readBits(1) == 0) {
+            dod = static_cast<int64_t>(readBits(9)) - 255;
+        } else if (readBits(1) == 0) {
+            dod = static_cast<int64_t>(readBits(12)) - 2047;
+        } else {
+            dod = static_cast<int64_t>(readBits(64));
+        }
+        delta += dod;
+        ts += delta;
+
+        if (readBits(1) == 1) {
+            if (readBits(1) == 1) {
+                leading = static_cast<uint8_t>(readBits(5));
+                int meaningful = static_cast<int>(readBits(6));
+                if (meaningful == 0) {
+                    meaningful = 64;
+                }
+                trailing = static_cast<uint8_t>(64 - leading - meaningful);
+            }
+            const int meaningful = 64 - leading - trailing;
+            bits ^= readBits(meaningful) << trailing;
+        }
+    }
+
+    index++;
+    timestamp = ts;
+    price = bitsToDouble(bits);
+    return true;
+}
+
+// ============================================================================
+// PriceSeriesStore 实现
+// ============================================================================
+
+void PriceSeriesStore::append(const std::string& productId, int64_t timestamp, double price) {
+    Series* s = nullptr;
+    {
+        std::shared_lock<std::shared_mutex> lock(mapMutex);
+        auto it = series.find(productId);
+        if (it != series.end()) {
+            s = it->second.get();
+        }
+    }
+    if (!s) {
+        std::unique_lock<std::shared_mutex> lock(mapMutex);
+        auto& slot = series[productId];
+        if (!slot) {
+            slot = std::make_unique<Series>();
+        }
+        s = slot.get();
+    }
+
+    std::lock_guard<std::mutex> lock(s->mutex);
+    timestamp = std::max(timestamp, s->lastTimestamp);  // 乱序点钳制，保证块内单调
+    if (s->blocks.empty() || s->blocks.back().full()) {
+        if (!s->blocks.empty()) {
+            s->blocks.back().seal();
+        }
+        s->blocks.emplace_back();
+    }
+    s->blocks.back().append(timestamp, price);
+    s->lastTimestamp = timestamp;
+    s->lastPrice = price;
+    s->points++;
+}
+
+const PriceSeriesStore::Series* PriceSeriesStore::find(const std::string& productId) const {
+    std::shared_lock<std::shared_mutex> lock(mapMutex);
+    auto it = series.find(productId);
+    return it != series.end() ? it->second.get() : nullptr;
+}
+
+std::vector<PricePoint> PriceSeriesStore::range(const std::string& productId,
+                                                int64_t from, int64_t to) const {
+    std::vector<PricePoint> result;
+    const Series* s = find(productId);
+    if (!s) {
+        return result;
+    }
+
+    std::lock_guard<std::mutex> lock(s->mutex);
+    for (const auto& block : s->blocks) {
+        if (block.lastTimestamp() < from) {
+            continue;  // 按块头裁剪
+        }
+        if (block.firstTimestamp() > to) {
+            break;
+        }
+        block.forEach([&](int64_t ts, double price) {
+            if (ts > to) {
+                return false;
+            }
+            if (ts >= from) {
+                result.push_back({ts, price});
+            }
+            return true;
+        });
+    }
+    return result;
+}
+
+std::vector<PriceBucket> PriceSeriesStore::downsample(const std::string& productId,
+                                                      int64_t from, int64_t to,
+                                                      int64_t bucketSeconds) const {
+    std::vector<PriceBucket> buckets;
+    const Series* s = find(productId);
+    if (!s || bucketSeconds <= 0) {
+        return buckets;
+    }
+
+    std::lock_guard<std::mutex> lock(s->mutex);
+    for (const auto& block : s->blocks) {
+        if (block.lastTimestamp() < from) {
+            continue;
+        }
+        if (block.firstTimestamp() > to) {
+            break;
+        }
+        block.forEach([&](int64_t ts, double price) {
+            if (ts > to) {
+                return false;
+            }
+            if (ts < from) {
+                return true;
+            }
+            const int64_t start = floorDiv(ts, bucketSeconds) * bucketSeconds;
+            if (buckets.empty() || buckets.back().start != start) {
+                buckets.push_back({start, price, price, price, price, 0});
+            }
+            PriceBucket& b = buckets.back();
+            b.high = std::max(b.high, price);
+            b.low = std::min(b.low, price);
+            b.close = price;
+            b.count++;
+            return true;
+        });
+    }
+    return buckets;
+}
+
+bool PriceSeriesStore::latest(const std::string& productId, PricePoint& point) const {
+    const Series* s = find(productId);
+    if (!s) {
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(s->mutex);
+    if (s->points == 0) {
+        return false;
+    }
+    point = {s->lastTimestamp, s->lastPrice};
+    return true;
+}
+
+std::vector<std::string> PriceSeriesStore::products() const {
+    std::shared_lock<std::shared_mutex> lock(mapMutex);
+    std::vector<std::string> ids;
+    ids.reserve(series.size());
+    for (const auto& entry : series) {
+        ids.push_back(entry.first);
+    }
+    return ids;
+}
+
+size_t PriceSeriesStore::pointCount() const {
+    std::shared_lock<std::shared_mutex> lock(mapMutex);
+    size_t total = 0;
+    for (const auto& entry : series) {
+        std::lock_guard<std::mutex> seriesLock(entry.second->mutex);
+        total += entry.second->points;
+    }
+    return total;
+}
+
+size_t PriceSeriesStore::memoryBytes() const {
+    std::shared_lock<std::shared_mutex> lock(mapMutex);
+    size_t total = 0;
+    for (const auto& entry : series) {
+        std::lock_guard<std::mutex> seriesLock(entry.second->mutex);
+        total += sizeof(Series) + entry.first.capacity();
+        for (const auto& block : entry.second->blocks) {
+            total += block.memoryBytes();
+        }
+    }
+    return total;
+}
@@ -0,0 +1,73 @@
+/**
+ * @file PricingArena.cpp
+ * @brief 定价周期内存池实现
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#include "PricingArena.h"
+#include <algorithm>
+
+namespace pricing {
+
+namespace {
+
+// 单个周期的缓冲上限；个别异常大的周期不应让缓冲无限膨胀
+constexpr size_t kMaxArenaBytes = 1024 * 1024;
+
+thread_local CycleArena* activeArena = nullptr;
+
+}  // namespace
+
+void* CycleArena::SpillCounter::do_allocate(size_t size, size_t alignment) {
+    bytes += size;
+    return std::pmr::new_delete_resource()->allocate(size, alignment);
+}
+
+void CycleArena::SpillCounter::do_deallocate(void* p, size_t size, size_t alignment) {
+    std::pmr::new_delete_resource()->deallocate(p, size, alignment);
+}
+
+CycleArena::CycleArena(size_t initialBytes)
+    : storage(new std::byte[initialBytes]), storageSize(initialBytes) {
+    buffer.emplace(storage.get(), storageSize, &upstream);
+}
+
+void CycleArena::reset() {
+    buffer->release();
+    if (upstream.bytes == 0 || storageSize >= kMaxArenaBytes) {
+        upstream.bytes = 0;
+        return;
+    }
+
+    // 本周期发生溢出：按高水位扩大初始缓冲
+    const size_t grown = std::min(kMaxArenaBytes, storageSize + upstream.bytes);
+    buffer.reset();
+    storage.reset(new std::byte[grown]);
+    storageSize = grown;
+    upstream.bytes = 0;
+    buffer.emplace(storage.get(), storageSize, &upstream);
+    spills++;
+}
+
+CycleArena& CycleArena::forThisThread() {
+    thread_local CycleArena arena;
+    return arena;
+}
+
+ArenaScope::ArenaScope(CycleArena& arena) : arena(arena), previous(activeArena) {
+    activeArena = &arena;
+}
+
+ArenaScope::~ArenaScope() {
+    activeArena = previous;
+    if (previous != &arena) {
+        arena.reset();
+    }
+}
+
+std::pmr::memory_resource* currentResource() {
+    return activeArena ? activeArena->resource() : std::pmr::new_delete_resource();
+}
+
+}  // namespace pricing
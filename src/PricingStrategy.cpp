@@ -2,7 +2,7 @@
 
 #include <algorithm>
 #include <cmath>
-#include <sstream>
+#include <cstdio>
 #include <string>
 
 namespace pricing {
@@ -16,6 +16,13 @@ constexpr double kMaxPriceMultiplier = 2.0;
 double safeDivider(double value) {
     return value == 0.0 ? 1.0 : value;
 }
+
+// 追加数字，格式与 ostream 默认输出一致 (same as default ostream formatting).
+void appendNumber(ArenaString& out, double value) {
+    char buffer[32];
+    const int length = std::snprintf(buffer, sizeof(buffer), "%g", value);
+    out.append(buffer, length > 0 ? static_cast<size_t>(length) : 0);
+}
 }  // namespace
 
 // 核心入口：融合多项启发式得到最终价格 (blend heuristics).
@@ -31,13 +38,12 @@ PricingResult PricingStrategy::calculatePrice(const Product& product,
     const double demandFactor = computeDemandFactor(product, context);
     const double timeFactor = computeTimeFactor(product, context);
 
-    const double adjustment = kStockWeight * stockFactor +
+    double adjustment = kStockWeight * stockFactor +
                               kCompetitorWeight * competitorFactor +
                               kDemandWeight * demandFactor +
                               kTimeWeight * timeFactor;
 
     PricingResult result{};
-    result.adjustment = adjustment;
     result.stockFactor = stockFactor;
     result.competitorFactor = competitorFactor;
     result.demandFactor = demandFactor;
@@ -46,35 +52,62 @@ PricingResult PricingStrategy::calculatePrice(const Product& product,
     const double unclampedPrice = product.basePrice * (1.0 + adjustment);
     result.newPrice = clampPrice(unclampedPrice, product.basePrice);
 
-    std::ostringstream oss;
-    oss << "Stock factor=" << stockFactor << ", competitor factor=" << competitorFactor
-        << ", demand factor=" << demandFactor << ", time factor=" << timeFactor << ". ";
+    // 旧款有清仓计划时直接采用计划折扣，调整量按计划价格回算 (clearance plan overrides the blend).
+    const bool followsClearancePlan = !product.isNewModel &&
+                                      context.newerModelInSeriesAvailable &&
+                                      context.plannedMarkdown >= 0.0;
+    if (followsClearancePlan) {
+        result.newPrice =
+            clampPrice(product.basePrice * (1.0 - context.plannedMarkdown), product.basePrice);
+        adjustment = result.newPrice / safeDivider(product.basePrice) - 1.0;
+    }
+    result.adjustment = adjustment;
 
-    if (!product.isNewModel && context.newerModelInSeriesAvailable) {
-        oss << "Newer model detected in series; discount applied. ";
+    // 说明文本直接写入结果字符串（周期内存池），不经过 ostringstream
+    ArenaString& explanation = result.strategyExplanation;
+    explanation.reserve(256);
+    explanation += "Stock factor=";
+    appendNumber(explanation, stockFactor);
+    explanation += ", competitor factor=";
+    appendNumber(explanation, competitorFactor);
+    explanation += ", demand factor=";
+    appendNumber(explanation, demandFactor);
+    explanation += ", time factor=";
+    appendNumber(explanation, timeFactor);
+    explanation += ". ";
+
+    if (followsClearancePlan) {
+        explanation += "Newer model detected in series; clearance plan markdown=";
+        appendNumber(explanation, context.plannedMarkdown * 100);
+        explanation += "%. ";
+    } else if (!product.isNewModel && context.newerModelInSeriesAvailable) {
+        explanation += "Newer model detected in series; discount applied. ";
     }
     if (context.competitorPrice > 0.0) {
         const double competitorGap =
             (context.competitorPrice - product.basePrice) / safeDivider(product.basePrice);
         if (competitorGap < -0.05) {
-            oss << "Competitor undercut detected (" << competitorGap * 100
-                << "%); responding with price decrease. ";
+            explanation += "Competitor undercut detected (";
+            appendNumber(explanation, competitorGap * 100);
+            explanation += "%); responding with price decrease. ";
         } else if (competitorGap > 0.05) {
-            oss << "Competitor priced higher; slight premium maintained. ";
+            explanation += "Competitor priced higher; slight premium maintained. ";
         }
     }
     if (context.isPeakSeason) {
-        oss << "Peak season active; seasonal strategy influencing price. ";
+        explanation += "Peak season active; seasonal strategy influencing price. ";
     }
     const double conversionRate =
         static_cast<double>(context.purchaseCount) / safeDivider(context.viewCount);
     if (context.viewCount > 50 && conversionRate < 0.05) {
-        oss << "High interest but low conversion; engagement discount applied. ";
+        explanation += "High interest but low conversion; engagement discount applied. ";
     }
 
-    oss << "Final adjustment=" << adjustment * 100 << "%, price clamped to "
-        << result.newPrice << ".";
-    result.strategyExplanation = oss.str();
+    explanation += "Final adjustment=";
+    appendNumber(explanation, adjustment * 100);
+    explanation += "%, price clamped to ";
+    appendNumber(explanation, result.newPrice);
+    explanation += ".";
 
     return result;
 }
@@ -124,6 +157,10 @@ double PricingStrategy::computeDemandFactor(const Product& product,
     (void)product;
     const double normalizedDemand = std::clamp(context.demandForecast / 200.0, -0.2, 0.2);
     double factor = normalizedDemand;
+    // 实测弹性：需求富有弹性（|e| > 1）时让利，缺乏弹性时小幅提价 (measured response).
+    if (context.priceElasticity < 0.0) {
+        factor += std::clamp(-0.05 * (-context.priceElasticity - 1.0), -0.05, 0.05);
+    }
     factor += applyUserBehaviorStrategy(product, context);
     return std::clamp(factor, -0.25, 0.25);
 }
@@ -147,7 +184,6 @@ double PricingStrategy::applyNewProductStrategy(const Product& product,
     if (product.isNewModel || !context.newerModelInSeriesAvailable) {
         return 0.0;
     }
-
     const double stockPressure =
         std::clamp(static_cast<double>(product.stock) / 500.0, 0.0, 1.0);
     return -0.05 - 0.1 * stockPressure;
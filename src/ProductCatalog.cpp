@@ -0,0 +1,197 @@
+/**
+ * @file ProductCatalog.cpp
+ * @brief 产品目录实现
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#include "ProductCatalog.h"
+#include "SimSupport.h"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+
+const char* categoryKey(ProductCategory category) {
+    switch (category) {
+        case ProductCategory::SMARTPHONE: return "smartphone";
+        case ProductCategory::LAPTOP: return "laptop";
+        case ProductCategory::GPU: return "gpu";
+        case ProductCategory::TABLET: return "tablet";
+        case ProductCategory::GENERAL: return "other";
+    }
+    return "other";
+}
+
+bool parseCategory(const std::string& text, ProductCategory& category) {
+    for (ProductCategory c : {ProductCategory::SMARTPHONE, ProductCategory::LAPTOP,
+                              ProductCategory::GPU, ProductCategory::TABLET,
+                              ProductCategory::GENERAL}) {
+        if (text == categoryKey(c)) {
+            category = c;
+            return true;
+        }
+    }
+    return false;
+}
+
+const char* lifecycleKey(Lifecycle lifecycle) {
+    switch (lifecycle) {
+        case Lifecycle::INTRODUCTION: return "introduction";
+        case Lifecycle::GROWTH: return "growth";
+        case Lifecycle::MATURITY: return "maturity";
+        case Lifecycle::DECLINE: return "decline";
+    }
+    return "maturity";
+}
+
+bool parseLifecycle(const std::string& text, Lifecycle& lifecycle) {
+    for (Lifecycle l : {Lifecycle::INTRODUCTION, Lifecycle::GROWTH, Lifecycle::MATURITY,
+                        Lifecycle::DECLINE}) {
+        if (text == lifecycleKey(l)) {
+            lifecycle = l;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool parseCivilDate(const std::string& text, int64_t& days) {
+    int year, month, day;
+    // 定长 "YYYY-MM-DD" 直接取数字（导入、校验、聚合都逐行调用），其余写法走 sscanf
+    bool fixedWidth = text.size() == 10 && text[4] == '-' && text[7] == '-';
+    for (size_t i = 0; fixedWidth && i < text.size(); ++i) {
+        fixedWidth = i == 4 || i == 7 || (text[i] >= '0' && text[i] <= '9');
+    }
+    if (fixedWidth) {
+        year = (text[0] - '0') * 1000 + (text[1] - '0') * 100 + (text[2] - '0') * 10 +
+               (text[3] - '0');
+        month = (text[5] - '0') * 10 + (text[6] - '0');
+        day = (text[8] - '0') * 10 + (text[9] - '0');
+    } else if (std::sscanf(text.c_str(), "%d-%d-%d", &year, &month, &day) != 3) {
+        return false;
+    }
+    // 按当月天数校验，"2025-02-31" 之类不会被折算到下个月
+    if (month < 1 || month > 12 || day < 1 || day > sim::daysInMonth(year, month)) {
+        return false;
+    }
+    days = sim::daysFromCivil(year, month, day);
+    return true;
+}
+
+// ============================================================================
+// ProductCatalog 实现
+// ============================================================================
+
+size_t ProductCatalog::loadFromFile(const std::string& filename) {
+    std::ifstream file(filename);
+    if (!file.is_open()) {
+        std::cerr << "Error: Cannot open catalog file " << filename << std::endl;
+        return 0;
+    }
+
+    std::string line;
+    std::getline(file, line);  // 跳过表头
+
+    size_t loaded = 0;
+    size_t lineNo = 1;
+    while (std::getline(file, line)) {
+        lineNo++;
+        if (line.empty()) {
+            continue;
+        }
+
+        // productId,name,category,series,isNewModel,lifecycle,launchDate
+        std::stringstream ss(line);
+        std::string fields[7];
+        for (auto& field : fields) {
+            std::getline(ss, field, ',');
+        }
+
+        ProductInfo info;
+        info.id = fields[0];
+        info.name = fields[1].empty() ? fields[0] : fields[1];
+        info.series = fields[3];
+        info.isNewModel = (fields[4] == "1" || fields[4] == "true");
+        if (info.id.empty() || !parseCategory(fields[2], info.category) ||
+            (!fields[5].empty() && !parseLifecycle(fields[5], info.lifecycle)) ||
+            (!fields[6].empty() && !parseCivilDate(fields[6], info.launchDay))) {
+            std::cerr << "Warning: Skipping malformed catalog line " << lineNo
+                      << " in " << filename << std::endl;
+            continue;
+        }
+
+        registerProduct(info);
+        loaded++;
+    }
+
+    std::cout << "Loaded " << loaded << " catalog entries from " << filename << std::endl;
+    return loaded;
+}
+
+uint32_t ProductCatalog::registerLocked(const ProductInfo& info) {
+    auto [it, inserted] = handles.try_emplace(info.id, static_cast<uint32_t>(products.size()));
+    if (inserted) {
+        products.push_back(info);
+        seriesIndex.addProduct(it->second, info.series, info.launchDay);
+    }
+    return it->second;
+}
+
+uint32_t ProductCatalog::registerProduct(const ProductInfo& info) {
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    return registerLocked(info);
+}
+
+uint32_t ProductCatalog::resolve(const std::string& productId) {
+    const uint32_t handle = find(productId);
+    if (handle != kInvalidHandle) {
+        return handle;
+    }
+    const ProductInfo inferred = inferFromId(productId);
+    std::unique_lock<std::shared_mutex> lock(mutex);
+    return registerLocked(inferred);
+}
+
+uint32_t ProductCatalog::find(const std::string& productId) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    auto it = handles.find(productId);
+    return it != handles.end() ? it->second : kInvalidHandle;
+}
+
+const ProductInfo& ProductCatalog::info(uint32_t handle) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);  // 只保护 deque 索引结构，元素本身不变
+    return products[handle];
+}
+
+size_t ProductCatalog::size() const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return products.size();
+}
+
+bool ProductCatalog::hasNewerInSeries(uint32_t handle, int64_t day) const {
+    std::shared_lock<std::shared_mutex> lock(mutex);
+    return seriesIndex.hasNewerAsOf(handle, day);
+}
+
+ProductInfo ProductCatalog::inferFromId(const std::string& productId) {
+    ProductInfo info;
+    info.id = productId;
+    info.name = productId;
+    if (productId.find("iPhone") != std::string::npos) {
+        info.category = ProductCategory::SMARTPHONE;
+    } else if (productId.find("MacBook") != std::string::npos) {
+        info.category = ProductCategory::LAPTOP;
+    } else if (productId.find("RTX") != std::string::npos) {
+        info.category = ProductCategory::GPU;
+    } else if (productId.find("iPad") != std::string::npos) {
+        info.category = ProductCategory::TABLET;
+    }
+    info.series = categoryKey(info.category);
+    info.isNewModel = (productId.find("New") != std::string::npos);
+    if (info.isNewModel) {
+        info.lifecycle = Lifecycle::INTRODUCTION;
+    }
+    return info;
+}
@@ -0,0 +1,244 @@
+/**
+ * @file RepricingScheduler.cpp
+ * @brief 时间轮调度器实现
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#include "RepricingScheduler.h"
+#include <algorithm>
+#include <iostream>
+
+RepricingScheduler::RepricingScheduler(Callback callback,
+                                       std::chrono::milliseconds tick,
+                                       size_t wheelSlots)
+    : callback(std::move(callback)),
+      tickDuration(std::max(tick, std::chrono::milliseconds(1))),
+      epoch(Clock::now()),
+      wheel(std::max<size_t>(wheelSlots, 1)),
+      stopFlag(false) {}
+
+RepricingScheduler::~RepricingScheduler() {
+    stop();
+}
+
+uint64_t RepricingScheduler::toTicks(std::chrono::milliseconds d) const {
+    const auto ticks = d.count() / tickDuration.count();
+    return ticks < 1 ? 1 : static_cast<uint64_t>(ticks);
+}
+
+void RepricingScheduler::insertLocked(uint32_t id) {
+    const uint64_t deadline = entries[id].deadlineTick;
+    wheel[deadline % wheel.size()].push_back({id, deadline});
+}
+
+void RepricingScheduler::schedule(const std::string& sku, std::chrono::milliseconds cadence) {
+    std::lock_guard<std::mutex> lock(wheelMutex);
+
+    // 以当前真实时间为基准，避免调度线程尚未推进时把新定时器算作迟到
+    const auto elapsed = Clock::now() - epoch;
+    const uint64_t nowTick = std::max<uint64_t>(
+        currentTick,
+        static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count() /
+                              tickDuration.count()));
+
+    uint32_t id;
+    auto it = index.find(sku);
+    if (it != index.end()) {
+        id = it->second;
+    } else if (!freeEntries.empty()) {
+        id = freeEntries.back();
+        freeEntries.pop_back();
+        index[sku] = id;
+    } else {
+        id = static_cast<uint32_t>(entries.size());
+        entries.emplace_back();
+        index[sku] = id;
+    }
+
+    TimerEntry& entry = entries[id];
+    if (!entry.active) {
+        entry = TimerEntry{};
+        entry.sku = sku;
+        entry.active = true;
+    }
+    entry.cadenceTicks = toTicks(cadence);
+    entry.deadlineTick = std::max(nowTick, currentTick) + entry.cadenceTicks;  // 旧节点惰性失效
+    insertLocked(id);
+}
+
+bool RepricingScheduler::cancel(const std::string& sku) {
+    std::lock_guard<std::mutex> lock(wheelMutex);
+    auto it = index.find(sku);
+    if (it == index.end()) {
+        return false;
+    }
+    entries[it->second].active = false;
+    freeEntries.push_back(it->second);
+    index.erase(it);
+    return true;
+}
+
+bool RepricingScheduler::triggerNow(const std::string& sku) {
+    {
+        std::lock_guard<std::mutex> lock(wheelMutex);
+        auto it = index.find(sku);
+        if (it == index.end()) {
+            return false;
+        }
+        TimerEntry& entry = entries[it->second];
+        if (entry.manualPending) {
+            coalescedCount++;  // 尚未派发的手动触发直接合并
+            return true;
+        }
+        entry.manualPending = true;
+        manualQueue.push_back(it->second);
+    }
+    cv.notify_one();
+    return true;
+}
+
+void RepricingScheduler::collectDueLocked(uint64_t slot, uint64_t nowTick,
+                                          std::vector<std::string>& due) {
+    std::vector<SlotNode>& nodes = wheel[slot];
+    std::vector<uint32_t> rescheduled;
+
+    size_t keep = 0;
+    for (size_t i = 0; i < nodes.size(); ++i) {
+        const SlotNode node = nodes[i];
+        TimerEntry& entry = entries[node.entry];
+
+        // 已取消或已改期的节点直接丢弃
+        if (!entry.active || entry.deadlineTick != node.deadlineTick) {
+            continue;
+        }
+        if (node.deadlineTick > nowTick) {
+            nodes[keep++] = node;  // 尚未到期（后续轮次）
+            continue;
+        }
+
+        if (nowTick > node.deadlineTick) {
+            entry.missed++;
+            missedCount++;
+        }
+
+        uint64_t next = node.deadlineTick + entry.cadenceTicks;
+        if (next <= nowTick) {
+            // 落后多个周期：只派发一次，其余周期合并
+            const uint64_t skipped = (nowTick - next) / entry.cadenceTicks + 1;
+            next += skipped * entry.cadenceTicks;
+            entry.missed += skipped;
+            missedCount += skipped;
+            coalescedCount += skipped;
+        }
+        entry.deadlineTick = next;
+        rescheduled.push_back(node.entry);
+
+        if (entry.lastQueuedTick == nowTick) {
+            coalescedCount++;
+        } else {
+            entry.lastQueuedTick = nowTick;
+            due.push_back(entry.sku);
+        }
+    }
+    nodes.resize(keep);
+
+    for (uint32_t id : rescheduled) {
+        insertLocked(id);
+    }
+}
+
+size_t RepricingScheduler::advance(Clock::time_point now) {
+    std::vector<std::string> due;
+    {
+        std::lock_guard<std::mutex> lock(wheelMutex);
+
+        uint64_t nowTick = currentTick;
+        if (now > epoch) {
+            nowTick = std::max<uint64_t>(
+                currentTick,
+                static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::milliseconds>(now - epoch).count() /
+                    tickDuration.count()));
+        }
+
+        for (uint32_t id : manualQueue) {
+            TimerEntry& entry = entries[id];
+            if (!entry.active || !entry.manualPending) {
+                continue;
+            }
+            entry.manualPending = false;
+            entry.lastQueuedTick = nowTick;
+            due.push_back(entry.sku);
+        }
+        manualQueue.clear();
+
+        // 落后超过一圈时每个槽位只扫描一次，到期条件为 deadline <= nowTick
+        const uint64_t lag = nowTick - currentTick;
+        const uint64_t slotsToScan = std::min<uint64_t>(lag, wheel.size());
+        for (uint64_t k = 1; k <= slotsToScan; ++k) {
+            collectDueLocked((currentTick + k) % wheel.size(), nowTick, due);
+        }
+        currentTick = nowTick;
+        dispatchedCount += due.size();
+    }
+
+    // 回调在锁外执行，允许在回调中重新 schedule / cancel
+    for (const auto& sku : due) {
+        try {
+            callback(sku);
+        } catch (const std::exception& e) {
+            std::cerr << "[Scheduler] callback failed for " << sku << ": " << e.what() << std::endl;
+        }
+    }
+    return due.size();
+}
+
+void RepricingScheduler::start() {
+    if (schedulerThread.joinable()) {
+        return;
+    }
+    stopFlag = false;
+    schedulerThread = std::thread(&RepricingScheduler::schedulerThreadFunc, this);
+}
+
+void RepricingScheduler::stop() {
+    stopFlag = true;
+    cv.notify_all();
+    if (schedulerThread.joinable()) {
+        schedulerThread.join();
+    }
+}
+
+void RepricingScheduler::schedulerThreadFunc() {
+    while (!stopFlag) {
+        {
+            std::unique_lock<std::mutex> lock(wheelMutex);
+            const auto nextTick = epoch + tickDuration * static_cast<int64_t>(currentTick + 1);
+            // 单线程按 tick 等待；手动触发或停止信号可提前唤醒
+            cv.wait_until(lock, nextTick, [this] {
+                return stopFlag.load() || !manualQueue.empty();
+            });
+            if (stopFlag) {
+                break;
+            }
+        }
+        advance(Clock::now());
+    }
+}
+
+SchedulerStats RepricingScheduler::getStats() const {
+    std::lock_guard<std::mutex> lock(wheelMutex);
+    SchedulerStats stats;
+    stats.dispatched = dispatchedCount;
+    stats.coalesced = coalescedCount;
+    stats.missedDeadlines = missedCount;
+    stats.activeTimers = index.size();
+    return stats;
+}
+
+uint64_t RepricingScheduler::getMissedDeadlines(const std::string& sku) const {
+    std::lock_guard<std::mutex> lock(wheelMutex);
+    auto it = index.find(sku);
+    return it != index.end() ? entries[it->second].missed : 0;
+}
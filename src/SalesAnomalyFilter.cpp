@@ -0,0 +1,101 @@
+/**
+ * @file SalesAnomalyFilter.cpp
+ * @brief 销量异常过滤实现
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#include "SalesAnomalyFilter.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+constexpr int kMaxWindow = 64;
+constexpr double kMadToSigma = 1.4826;  // 正态分布下 σ ≈ 1.4826 × MAD
+
+}  // namespace
+
+SalesAnomalyFilter::SalesAnomalyFilter(const AnomalyConfig& config) : config(config) {
+    this->config.window = std::clamp(this->config.window, 1, kMaxWindow);
+    this->config.minSamples = std::clamp(this->config.minSamples, 1, this->config.window);
+    scratch.reserve(kMaxWindow);
+}
+
+double SalesAnomalyFilter::median(const std::vector<double>& sorted) {
+    const size_t n = sorted.size();
+    return n % 2 ? sorted[n / 2] : 0.5 * (sorted[n / 2 - 1] + sorted[n / 2]);
+}
+
+double SalesAnomalyFilter::mad(const std::vector<double>& sorted, double center) {
+    scratch.clear();
+    for (double v : sorted) {
+        scratch.push_back(std::fabs(v - center));
+    }
+    const size_t n = scratch.size();
+    auto mid = scratch.begin() + n / 2;
+    std::nth_element(scratch.begin(), mid, scratch.end());
+    if (n % 2) {
+        return *mid;
+    }
+    // 偶数个：与左半部分的最大值取平均
+    return 0.5 * (*mid + *std::max_element(scratch.begin(), mid));
+}
+
+void SalesAnomalyFilter::push(ProductWindow& w, double value, size_t capacity) {
+    if (w.ring.size() < capacity) {
+        w.ring.push_back(value);
+    } else {
+        // 从有序副本中移除最旧的值
+        const double oldest = w.ring[w.next];
+        w.sorted.erase(std::lower_bound(w.sorted.begin(), w.sorted.end(), oldest));
+        w.ring[w.next] = value;
+        w.next = (w.next + 1) % capacity;
+    }
+    w.sorted.insert(std::upper_bound(w.sorted.begin(), w.sorted.end(), value), value);
+}
+
+bool SalesAnomalyFilter::observe(Sale& sale, size_t row) {
+    ProductWindow& w = windows[sale.productId];
+    const double value = static_cast<double>(sale.sales);
+    bool isAnomaly = false;
+
+    if (static_cast<int>(w.sorted.size()) >= config.minSamples) {
+        const double center = median(w.sorted);
+        // MAD 为 0（窗口内销量完全相同）时按中位数的 10%（至少 1 件）作为尺度下限
+        const double scale = std::max(kMadToSigma * mad(w.sorted, center),
+                                      std::max(1.0, 0.1 * std::fabs(center)));
+        const double score = std::fabs(value - center) / scale;
+
+        if (score > config.threshold) {
+            isAnomaly = true;
+            SalesAnomaly anomaly;
+            anomaly.row = row;
+            anomaly.date = sale.date;
+            anomaly.productId = sale.productId;
+            anomaly.original = sale.sales;
+            anomaly.score = score;
+            if (config.action == AnomalyAction::WINSORIZE) {
+                const double bound = config.threshold * scale;
+                const double clipped = std::clamp(value, center - bound, center + bound);
+                sale.sales = std::max(0, static_cast<int>(std::lround(clipped)));
+            }
+            anomaly.replacement = sale.sales;
+            sale.flagged = true;
+            flagged.push_back(std::move(anomaly));
+        }
+    }
+
+    // 窗口保存原始值：中位数本身稳健，且能跟上真实的水平变化
+    push(w, value, static_cast<size_t>(config.window));
+    return isAnomaly;
+}
+
+const std::vector<SalesAnomaly>& SalesAnomalyFilter::anomalies() const {
+    return flagged;
+}
+
+void SalesAnomalyFilter::clear() {
+    windows.clear();
+    flagged.clear();
+}
@@ -0,0 +1,266 @@
+/**
+ * @file SalesColumns.cpp
+ * @brief 压缩销售列实现
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#include "SalesColumns.h"
+#include "DailyHistory.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define SALES_COLUMNS_SSE2 1
+#endif
+
+namespace {
+
+constexpr size_t kLanes = 4;
+constexpr size_t kPerLane = SalesColumns::kBlockSize / kLanes;  // 每路 32 个值
+
+uint32_t bitsNeeded(uint32_t maxValue) {
+    uint32_t bits = 0;
+    while (bits < 32 && (maxValue >> bits) != 0) {
+        bits++;
+    }
+    return bits;
+}
+
+/**
+ * @brief 128 个值按 4 路纵向布局打包为 4 × bits 个字
+ * 第 j 个值位于第 j % 4 路、该路比特流的第 (j / 4) × bits 位
+ */
+void pack128(const uint32_t* in, uint32_t bits, uint32_t* out) {
+    std::fill(out, out + kLanes * bits, 0u);
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+        uint32_t bitPos = 0;
+        size_t word = 0;
+        for (size_t k = 0; k < kPerLane; ++k) {
+            const uint32_t v = in[k * kLanes + lane];
+            out[word * kLanes + lane] |= v << bitPos;
+            if (bitPos + bits > 32) {
+                out[(word + 1) * kLanes + lane] |= v >> (32 - bitPos);
+            }
+            bitPos += bits;
+            if (bitPos >= 32) {
+                bitPos -= 32;
+                word++;
+            }
+        }
+    }
+}
+
+/**
+ * @brief pack128 的逆过程：每次从 4 路各解出一个值
+ */
+void unpack128(const uint32_t* in, uint32_t bits, uint32_t* out) {
+    if (bits == 0) {
+        std::fill(out, out + SalesColumns::kBlockSize, 0u);
+        return;
+    }
+#ifdef SALES_COLUMNS_SSE2
+    const __m128i mask = _mm_set1_epi32(bits == 32 ? -1 : static_cast<int>((1u << bits) - 1));
+    const __m128i* src = reinterpret_cast<const __m128i*>(in);
+    __m128i current = _mm_loadu_si128(src);
+    uint32_t bitPos = 0;
+    size_t word = 0;
+    for (size_t k = 0; k < kPerLane; ++k) {
+        __m128i v = _mm_srl_epi32(current, _mm_cvtsi32_si128(static_cast<int>(bitPos)));
+        if (bitPos + bits > 32) {
+            const __m128i next = _mm_loadu_si128(src + word + 1);
+            v = _mm_or_si128(v, _mm_sll_epi32(next, _mm_cvtsi32_si128(static_cast<int>(32 - bitPos))));
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + k * kLanes), _mm_and_si128(v, mask));
+        bitPos += bits;
+        if (bitPos >= 32) {
+            bitPos -= 32;
+            if (++word < bits) {
+                current = _mm_loadu_si128(src + word);
+            }
+        }
+    }
+#else
+    const uint32_t mask = bits == 32 ? ~0u : (1u << bits) - 1;
+    for (size_t lane = 0; lane < kLanes; ++lane) {
+        uint32_t bitPos = 0;
+        size_t word = 0;
+        for (size_t k = 0; k < kPerLane; ++k) {
+            uint32_t v = in[word * kLanes + lane] >> bitPos;
+            if (bitPos + bits > 32) {
+                v |= in[(word + 1) * kLanes + lane] << (32 - bitPos);
+            }
+            out[k * kLanes + lane] = v & mask;
+            bitPos += bits;
+            if (bitPos >= 32) {
+                bitPos -= 32;
+                word++;
+            }
+        }
+    }
+#endif
+}
+
+// 参考帧还原：out[i] = base + offset[i]
+void addBase(const uint32_t* offsets, int32_t base, int32_t* out) {
+#ifdef SALES_COLUMNS_SSE2
+    const __m128i vbase = _mm_set1_epi32(base);
+    for (size_t i = 0; i < SalesColumns::kBlockSize; i += kLanes) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(offsets + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_add_epi32(v, vbase));
+    }
+#else
+    for (size_t i = 0; i < SalesColumns::kBlockSize; ++i) {
+        out[i] = static_cast<int32_t>(static_cast<uint32_t>(base) + offsets[i]);
+    }
+#endif
+}
+
+// zigzag 解码后做前缀和：out[0] = first，out[i] = out[i-1] + delta[i]
+void undoDeltas(uint32_t* deltas, int32_t first, int32_t* out) {
+#ifdef SALES_COLUMNS_SSE2
+    const __m128i one = _mm_set1_epi32(1);
+    const __m128i zero = _mm_setzero_si128();
+    for (size_t i = 0; i < SalesColumns::kBlockSize; i += kLanes) {
+        __m128i* p = reinterpret_cast<__m128i*>(deltas + i);
+        const __m128i v = _mm_loadu_si128(p);
+        const __m128i sign = _mm_sub_epi32(zero, _mm_and_si128(v, one));
+        _mm_storeu_si128(p, _mm_xor_si128(_mm_srli_epi32(v, 1), sign));
+    }
+#else
+    for (size_t i = 0; i < SalesColumns::kBlockSize; ++i) {
+        deltas[i] = (deltas[i] >> 1) ^ (0u - (deltas[i] & 1u));
+    }
+#endif
+    uint32_t running = static_cast<uint32_t>(first);
+    out[0] = first;
+    for (size_t i = 1; i < SalesColumns::kBlockSize; ++i) {
+        running += deltas[i];
+        out[i] = static_cast<int32_t>(running);
+    }
+}
+
+}  // namespace
+
+SalesColumns SalesColumns::fromSeries(const DailySeries& series) {
+    SalesColumns columns;
+    for (int64_t day = series.firstDay(); !series.empty() && day <= series.lastDay(); ++day) {
+        columns.append(static_cast<int32_t>(std::lround(series.sales(day))), series.stock(day),
+                       series.price(day));
+    }
+    return columns;
+}
+
+void SalesColumns::append(int32_t sales, int32_t stock, double price) {
+    if (priceRuns.empty() || priceRuns.back().price != price) {
+        priceRuns.push_back({count, price});
+    }
+    pendingSales.push_back(sales);
+    pendingStock.push_back(stock);
+    count++;
+    if (pendingSales.size() == kBlockSize) {
+        sealBlock();
+    }
+}
+
+void SalesColumns::sealBlock() {
+    Block block;
+    uint32_t scratch[kBlockSize];
+
+    // 销量：参考帧
+    block.salesBase = *std::min_element(pendingSales.begin(), pendingSales.end());
+    uint32_t maxOffset = 0;
+    for (size_t i = 0; i < kBlockSize; ++i) {
+        scratch[i] = static_cast<uint32_t>(pendingSales[i]) - static_cast<uint32_t>(block.salesBase);
+        maxOffset = std::max(maxOffset, scratch[i]);
+    }
+    block.salesBits = static_cast<uint8_t>(bitsNeeded(maxOffset));
+    block.salesOffset = static_cast<uint32_t>(words.size());
+    words.resize(words.size() + kLanes * block.salesBits);
+    pack128(scratch, block.salesBits, words.data() + block.salesOffset);
+
+    // 库存：差分 + zigzag
+    block.stockFirst = pendingStock[0];
+    uint32_t maxDelta = 0;
+    scratch[0] = 0;
+    for (size_t i = 1; i < kBlockSize; ++i) {
+        const uint32_t d = static_cast<uint32_t>(pendingStock[i]) - static_cast<uint32_t>(pendingStock[i - 1]);
+        scratch[i] = (d << 1) ^ (0u - (d >> 31));
+        maxDelta = std::max(maxDelta, scratch[i]);
+    }
+    block.stockBits = static_cast<uint8_t>(bitsNeeded(maxDelta));
+    block.stockOffset = static_cast<uint32_t>(words.size());
+    words.resize(words.size() + kLanes * block.stockBits);
+    pack128(scratch, block.stockBits, words.data() + block.stockOffset);
+
+    blocks.push_back(block);
+    pendingSales.clear();
+    pendingStock.clear();
+}
+
+size_t SalesColumns::size() const {
+    return count;
+}
+
+size_t SalesColumns::blockCount() const {
+    return blocks.size() + (pendingSales.empty() ? 0 : 1);
+}
+
+size_t SalesColumns::decodeSales(size_t block, int32_t* out) const {
+    if (block >= blocks.size()) {
+        if (block > blocks.size()) {
+            return 0;
+        }
+        std::copy(pendingSales.begin(), pendingSales.end(), out);
+        return pendingSales.size();
+    }
+    uint32_t offsets[kBlockSize];
+    const Block& b = blocks[block];
+    unpack128(words.data() + b.salesOffset, b.salesBits, offsets);
+    addBase(offsets, b.salesBase, out);
+    return kBlockSize;
+}
+
+size_t SalesColumns::decodeStock(size_t block, int32_t* out) const {
+    if (block >= blocks.size()) {
+        if (block > blocks.size()) {
+            return 0;
+        }
+        std::copy(pendingStock.begin(), pendingStock.end(), out);
+        return pendingStock.size();
+    }
+    uint32_t deltas[kBlockSize];
+    const Block& b = blocks[block];
+    unpack128(words.data() + b.stockOffset, b.stockBits, deltas);
+    undoDeltas(deltas, b.stockFirst, out);
+    return kBlockSize;
+}
+
+size_t SalesColumns::decodePrices(size_t block, double* out) const {
+    const uint64_t begin = static_cast<uint64_t>(block) * kBlockSize;
+    if (begin >= count) {
+        return 0;
+    }
+    const size_t length = static_cast<size_t>(std::min<uint64_t>(kBlockSize, count - begin));
+
+    // 找到覆盖 begin 的游程，然后按游程整段填充
+    auto run = std::upper_bound(priceRuns.begin(), priceRuns.end(), begin,
+                                [](uint64_t day, const PriceRun& r) { return day < r.start; }) - 1;
+    size_t i = 0;
+    while (i < length) {
+        auto next = run + 1;
+        const uint64_t runEnd = next == priceRuns.end() ? count : next->start;
+        const size_t stop = static_cast<size_t>(std::min<uint64_t>(runEnd - begin, length));
+        std::fill(out + i, out + stop, run->price);
+        i = stop;
+        run = next;
+    }
+    return length;
+}
+
+size_t SalesColumns::memoryBytes() const {
+    return blocks.size() * sizeof(Block) + words.size() * sizeof(uint32_t) +
+           priceRuns.size() * sizeof(PriceRun) +
+           (pendingSales.size() + pendingStock.size()) * sizeof(int32_t);
+}
@@ -0,0 +1,153 @@
+/**
+ * @file SalesPartitioner.cpp
+ * @brief 外存分区实现
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#include "SalesPartitioner.h"
+#include "DecompressingReader.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <string_view>
+
+namespace {
+
+// CSV 一行约 30~40 字节，解析成 Sale 并放入 vector 后约为其 3 倍
+constexpr size_t kInMemoryExpansion = 3;
+
+// 压缩文件按典型的文本压缩比估算解压后大小
+constexpr size_t kCompressionRatio = 5;
+
+}  // namespace
+
+SalesPartitioner::SalesPartitioner(const PartitionConfig& config) : config(config) {
+    this->config.memoryBudgetBytes = std::max<size_t>(this->config.memoryBudgetBytes, 1u << 20);
+    this->config.maxPartitions = std::max<size_t>(this->config.maxPartitions, 1);
+}
+
+SalesPartitioner::~SalesPartitioner() {
+    removeFiles();
+}
+
+void SalesPartitioner::removeFiles() {
+    if (ownsFiles) {
+        std::error_code ec;
+        for (const std::string& path : partitionFiles) {
+            std::filesystem::remove(path, ec);
+        }
+    }
+    partitionFiles.clear();
+    ownsFiles = false;
+}
+
+bool SalesPartitioner::partition(const std::string& filename) {
+    removeFiles();
+
+    std::error_code ec;
+    const auto fileSize = std::filesystem::file_size(filename, ec);
+    if (ec) {
+        std::cerr << "Error: Cannot open file " << filename << std::endl;
+        return false;
+    }
+
+    const bool compressed = DecompressingReader::detect(filename) != CompressionFormat::NONE;
+    const size_t needed = static_cast<size_t>(fileSize) * kInMemoryExpansion *
+                          (compressed ? kCompressionRatio : 1);
+    const size_t count = std::min(config.maxPartitions,
+                                  (needed + config.memoryBudgetBytes - 1) / config.memoryBudgetBytes);
+    if (count <= 1) {
+        // 整个文件放得进预算：直接按单个分区读取原文件
+        partitionFiles.push_back(filename);
+        return true;
+    }
+    if (count == config.maxPartitions && needed / count > config.memoryBudgetBytes) {
+        std::cerr << "Warning: " << count << " partitions exceed the memory budget; "
+                  << "raise maxPartitions or the budget" << std::endl;
+    }
+
+    DecompressingReader in;
+    std::filesystem::create_directories(config.spillDirectory, ec);
+    std::string header;
+    if (!in.open(filename) || !in.getline(header)) {
+        std::cerr << "Error: Cannot read file " << filename << std::endl;
+        return false;
+    }
+
+    const std::string stem = std::filesystem::path(filename).filename().string();
+    std::vector<std::unique_ptr<std::ofstream>> outputs;
+    ownsFiles = true;
+    for (size_t i = 0; i < count; ++i) {
+        partitionFiles.push_back(config.spillDirectory + "/" + stem + ".part" + std::to_string(i));
+        outputs.push_back(std::make_unique<std::ofstream>(partitionFiles.back(), std::ios::binary));
+        if (!outputs.back()->is_open()) {
+            std::cerr << "Error: Cannot create partition " << partitionFiles.back() << std::endl;
+            outputs.clear();
+            removeFiles();
+            return false;
+        }
+        *outputs.back() << header << '\n';  // 每个分区带标题行，可直接交给 DataLoader
+    }
+
+    // 按产品 ID 哈希分配，同一产品的行保持输入顺序
+    std::hash<std::string_view> hasher;
+    std::string line;
+    while (in.getline(line)) {
+        const size_t dateEnd = line.find(',');
+        const size_t idEnd = dateEnd == std::string::npos ? dateEnd : line.find(',', dateEnd + 1);
+        const std::string_view productId =
+            idEnd == std::string::npos
+                ? std::string_view()
+                : std::string_view(line).substr(dateEnd + 1, idEnd - dateEnd - 1);
+        *outputs[hasher(productId) % count] << line << '\n';
+    }
+
+    for (auto& out : outputs) {
+        out->close();
+        if (!*out || in.failed()) {
+            std::cerr << "Error: Failed writing partition files" << std::endl;
+            removeFiles();
+            return false;
+        }
+    }
+    return true;
+}
+
+size_t SalesPartitioner::forEachProduct(const GroupCallback& callback) const {
+    size_t products = 0;
+    for (const std::string& path : partitionFiles) {
+        DataLoader loader(path);
+        if (!loader.loadData()) {
+            continue;
+        }
+        std::vector<Sale> rows = loader.releaseSalesData();
+
+        // 稳定排序：产品内部保持原有（日期）顺序
+        std::stable_sort(rows.begin(), rows.end(), [](const Sale& a, const Sale& b) {
+            return a.productId < b.productId;
+        });
+
+        std::vector<Sale> group;
+        for (size_t begin = 0; begin < rows.size();) {
+            size_t end = begin + 1;
+            while (end < rows.size() && rows[end].productId == rows[begin].productId) {
+                end++;
+            }
+            group.assign(std::make_move_iterator(rows.begin() + begin),
+                         std::make_move_iterator(rows.begin() + end));
+            const std::string productId = group.front().productId;
+            callback(productId, group);
+            products++;
+            begin = end;
+        }
+    }
+    return products;
+}
+
+size_t SalesPartitioner::partitionCount() const {
+    return partitionFiles.size();
+}
@@ -0,0 +1,409 @@
+/**
+ * @file SalesQuery.cpp
+ * @brief 销售聚合查询实现
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#include "SalesQuery.h"
+#include "DailyHistory.h"
+#include "ProductCatalog.h"
+#include "SimSupport.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <limits>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+namespace {
+
+/**
+ * @brief 分组键的值：产品 ID 以 string_view 引用原记录，其余键编码为整数
+ * hash 在扫描时算好一次，既用于选分区也作为哈希表的哈希值
+ */
+struct GroupTuple {
+    std::string_view product;
+    int64_t parts[SalesQuery::kMaxKeys] = {0, 0, 0};
+    size_t hash = 0;
+
+    bool operator==(const GroupTuple& other) const {
+        return product == other.product && std::equal(parts, parts + SalesQuery::kMaxKeys,
+                                                      other.parts);
+    }
+};
+
+struct TupleHash {
+    size_t operator()(const GroupTuple& t) const { return t.hash; }
+};
+
+/**
+ * @brief 单个聚合的累加状态（各聚合函数共用，合并时逐字段合并）
+ */
+struct Cell {
+    double sum = 0.0;
+    double min = std::numeric_limits<double>::infinity();
+    double max = -std::numeric_limits<double>::infinity();
+    double last = 0.0;
+    int64_t lastDay = INT64_MIN;
+    size_t count = 0;
+
+    void add(double v, int64_t day) {
+        sum += v;
+        min = std::min(min, v);
+        max = std::max(max, v);
+        if (day >= lastDay) {
+            lastDay = day;
+            last = v;
+        }
+        count++;
+    }
+
+    // other 来自更靠后的记录段，同一天时以它为准
+    void merge(const Cell& other) {
+        sum += other.sum;
+        min = std::min(min, other.min);
+        max = std::max(max, other.max);
+        if (other.count > 0 && other.lastDay >= lastDay) {
+            lastDay = other.lastDay;
+            last = other.last;
+        }
+        count += other.count;
+    }
+};
+
+using GroupMap = std::unordered_map<GroupTuple, std::vector<Cell>, TupleHash>;
+
+double measureOf(const Sale& s, Measure measure) {
+    switch (measure) {
+        case Measure::UNITS: return s.sales;
+        case Measure::REVENUE: return s.sales * s.price;
+        case Measure::PRICE: return s.price;
+        case Measure::STOCK: return s.stock;
+    }
+    return 0.0;
+}
+
+const char* keyName(GroupKey key) {
+    switch (key) {
+        case GroupKey::PRODUCT: return "product";
+        case GroupKey::CATEGORY: return "category";
+        case GroupKey::DAY: return "day";
+        case GroupKey::WEEK: return "week";
+        case GroupKey::MONTH: return "month";
+    }
+    return "";
+}
+
+const char* measureName(Measure measure) {
+    switch (measure) {
+        case Measure::UNITS: return "units";
+        case Measure::REVENUE: return "revenue";
+        case Measure::PRICE: return "price";
+        case Measure::STOCK: return "stock";
+    }
+    return "";
+}
+
+const char* opName(AggregateOp op) {
+    switch (op) {
+        case AggregateOp::SUM: return "sum";
+        case AggregateOp::MEAN: return "mean";
+        case AggregateOp::MIN: return "min";
+        case AggregateOp::MAX: return "max";
+        case AggregateOp::COUNT: return "count";
+        case AggregateOp::LAST: return "last";
+    }
+    return "";
+}
+
+// 1970-01-01 是周四，向前退到周一
+int64_t weekStart(int64_t day) {
+    return day - ((day % 7 + 7 + 3) % 7);
+}
+
+std::string formatKey(GroupKey key, const GroupTuple& t, size_t i) {
+    switch (key) {
+        case GroupKey::PRODUCT: return std::string(t.product);
+        case GroupKey::CATEGORY: return categoryKey(static_cast<ProductCategory>(t.parts[i]));
+        case GroupKey::DAY:
+        case GroupKey::WEEK: return DailyHistory::formatDay(t.parts[i]);
+        case GroupKey::MONTH: {
+            char buffer[16];
+            std::snprintf(buffer, sizeof(buffer), "%04d-%02d",
+                          static_cast<int>(t.parts[i] / 12), static_cast<int>(t.parts[i] % 12) + 1);
+            return buffer;
+        }
+    }
+    return "";
+}
+
+}  // namespace
+
+bool AggregateTable::writeCsv(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        std::cerr << "Error: Cannot create " << path << std::endl;
+        return false;
+    }
+    for (size_t i = 0; i < columns.size(); ++i) {
+        out << (i ? "," : "") << columns[i];
+    }
+    out << "\n";
+    for (const AggregateRow& row : rows) {
+        for (size_t i = 0; i < row.keys.size(); ++i) {
+            out << (i ? "," : "") << row.keys[i];
+        }
+        for (size_t i = 0; i < row.values.size(); ++i) {
+            out << (i || !row.keys.empty() ? "," : "") << row.values[i];
+        }
+        out << "\n";
+    }
+    return static_cast<bool>(out);
+}
+
+SalesQuery::SalesQuery(const std::vector<Sale>& rows, const ProductCatalog* catalog)
+    : rows(rows), catalog(catalog) {}
+
+SalesQuery& SalesQuery::groupBy(GroupKey key) {
+    if (keys.size() == kMaxKeys) {
+        std::cerr << "Warning: SalesQuery supports at most " << kMaxKeys
+                  << " group keys, ignoring " << keyName(key) << std::endl;
+        return *this;
+    }
+    keys.push_back(key);
+    return *this;
+}
+
+SalesQuery& SalesQuery::where(std::function<bool(const Sale&)> filter) {
+    predicate = std::move(filter);
+    return *this;
+}
+
+SalesQuery& SalesQuery::add(AggregateOp op, Measure measure) {
+    aggregates.push_back({op, measure});
+    return *this;
+}
+
+SalesQuery& SalesQuery::sum(Measure measure) { return add(AggregateOp::SUM, measure); }
+SalesQuery& SalesQuery::mean(Measure measure) { return add(AggregateOp::MEAN, measure); }
+SalesQuery& SalesQuery::min(Measure measure) { return add(AggregateOp::MIN, measure); }
+SalesQuery& SalesQuery::max(Measure measure) { return add(AggregateOp::MAX, measure); }
+SalesQuery& SalesQuery::last(Measure measure) { return add(AggregateOp::LAST, measure); }
+SalesQuery& SalesQuery::count() { return add(AggregateOp::COUNT, Measure::UNITS); }
+
+SalesQuery& SalesQuery::orderBy(size_t column, bool desc) {
+    orderColumn = column;
+    descending = desc;
+    return *this;
+}
+
+SalesQuery& SalesQuery::limit(size_t maxRows) {
+    rowLimit = maxRows;
+    return *this;
+}
+
+SalesQuery& SalesQuery::threads(unsigned count) {
+    numThreads = count;
+    return *this;
+}
+
+AggregateTable SalesQuery::run() const {
+    AggregateTable table;
+    for (GroupKey key : keys) {
+        table.columns.push_back(keyName(key));
+    }
+    for (const Aggregate& a : aggregates) {
+        table.columns.push_back(a.op == AggregateOp::COUNT
+                                    ? std::string("count")
+                                    : std::string(opName(a.op)) + "(" + measureName(a.measure) + ")");
+    }
+    if (orderColumn != SIZE_MAX && orderColumn >= aggregates.size()) {
+        std::cerr << "Error: SalesQuery orderBy column " << orderColumn << " out of range"
+                  << std::endl;
+        return table;
+    }
+
+    const size_t n = rows.size();
+    unsigned workers = numThreads ? numThreads : std::max(1u, std::thread::hardware_concurrency());
+    workers = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(workers, n / 4096)));
+    const unsigned partitions = workers;
+
+    const bool needsDay = std::any_of(keys.begin(), keys.end(), [](GroupKey k) {
+        return k == GroupKey::DAY || k == GroupKey::WEEK || k == GroupKey::MONTH;
+    }) || std::any_of(aggregates.begin(), aggregates.end(), [](const Aggregate& a) {
+        return a.op == AggregateOp::LAST;
+    });
+    const bool hasProductKey = std::find(keys.begin(), keys.end(), GroupKey::PRODUCT) != keys.end();
+
+    // local[t][p]：线程 t 的记录段中落在分区 p 的分组
+    std::vector<std::vector<GroupMap>> local(workers, std::vector<GroupMap>(partitions));
+    std::vector<size_t> skipped(workers, 0);
+    const size_t chunkSize = (n + workers - 1) / workers;
+
+    auto scanChunk = [&](unsigned t) {
+        const size_t begin = std::min(n, t * chunkSize);
+        const size_t end = std::min(n, begin + chunkSize);
+        std::unordered_map<std::string_view, ProductCategory> categories;
+        std::hash<std::string_view> hasher;
+        for (size_t r = begin; r < end; ++r) {
+            const Sale& s = rows[r];
+            if (predicate && !predicate(s)) {
+                continue;
+            }
+            int64_t day = 0;
+            if (needsDay && !parseCivilDate(s.date, day)) {
+                skipped[t]++;
+                continue;
+            }
+
+            GroupTuple tuple;
+            uint64_t h = 0x9E3779B97F4A7C15ULL;
+            for (size_t i = 0; i < keys.size(); ++i) {
+                int64_t part = 0;
+                switch (keys[i]) {
+                    case GroupKey::PRODUCT: break;
+                    case GroupKey::CATEGORY: {
+                        auto it = categories.find(s.productId);
+                        if (it == categories.end()) {
+                            const uint32_t handle =
+                                catalog ? catalog->find(s.productId) : ProductCatalog::kInvalidHandle;
+                            const ProductCategory c =
+                                handle != ProductCatalog::kInvalidHandle
+                                    ? catalog->info(handle).category
+                                    : ProductCatalog::inferFromId(s.productId).category;
+                            it = categories.emplace(s.productId, c).first;
+                        }
+                        part = static_cast<int64_t>(it->second);
+                        break;
+                    }
+                    case GroupKey::DAY: part = day; break;
+                    case GroupKey::WEEK: part = weekStart(day); break;
+                    case GroupKey::MONTH: {
+                        int year, month, dayOfMonth;
+                        sim::civilFromDays(day, year, month, dayOfMonth);
+                        part = static_cast<int64_t>(year) * 12 + (month - 1);
+                        break;
+                    }
+                }
+                tuple.parts[i] = part;
+                h = sim::mixSeed(h, static_cast<uint64_t>(part));
+            }
+            if (hasProductKey) {
+                tuple.product = s.productId;
+                h ^= hasher(tuple.product);
+            }
+            tuple.hash = static_cast<size_t>(h);
+
+            std::vector<Cell>& cells = local[t][h % partitions][tuple];
+            cells.resize(aggregates.size());
+            for (size_t a = 0; a < aggregates.size(); ++a) {
+                cells[a].add(measureOf(s, aggregates[a].measure), day);
+            }
+        }
+    };
+
+    // 分区 p 按线程顺序合并（LAST 在同一天时保持记录顺序）
+    std::vector<std::vector<std::pair<GroupTuple, std::vector<Cell>>>> merged(partitions);
+    auto mergePartition = [&](unsigned p) {
+        GroupMap groups = std::move(local[0][p]);
+        for (unsigned t = 1; t < workers; ++t) {
+            for (auto& [tuple, cells] : local[t][p]) {
+                auto [it, inserted] = groups.try_emplace(tuple);
+                if (inserted) {
+                    it->second = std::move(cells);
+                    continue;
+                }
+                for (size_t a = 0; a < cells.size(); ++a) {
+                    it->second[a].merge(cells[a]);
+                }
+            }
+            GroupMap().swap(local[t][p]);
+        }
+        merged[p].assign(std::make_move_iterator(groups.begin()),
+                         std::make_move_iterator(groups.end()));
+    };
+
+    auto runParallel = [&](auto&& task) {
+        std::vector<std::thread> pool;
+        for (unsigned t = 1; t < workers; ++t) {
+            pool.emplace_back(task, t);
+        }
+        task(0u);
+        for (auto& th : pool) {
+            th.join();
+        }
+    };
+    runParallel(scanChunk);
+    runParallel(mergePartition);
+
+    size_t totalSkipped = 0;
+    for (size_t s : skipped) {
+        totalSkipped += s;
+    }
+    if (totalSkipped > 0) {
+        std::cerr << "Warning: SalesQuery skipped " << totalSkipped << " rows with invalid dates"
+                  << std::endl;
+    }
+
+    // 结果值
+    struct Group {
+        const GroupTuple* tuple;
+        std::vector<double> values;
+    };
+    std::vector<Group> groups;
+    for (const auto& part : merged) {
+        for (const auto& [tuple, cells] : part) {
+            Group g{&tuple, {}};
+            for (size_t a = 0; a < aggregates.size(); ++a) {
+                const Cell& c = cells[a];
+                double v = 0.0;
+                switch (aggregates[a].op) {
+                    case AggregateOp::SUM: v = c.sum; break;
+                    case AggregateOp::MEAN: v = c.sum / static_cast<double>(c.count); break;
+                    case AggregateOp::MIN: v = c.min; break;
+                    case AggregateOp::MAX: v = c.max; break;
+                    case AggregateOp::COUNT: v = static_cast<double>(c.count); break;
+                    case AggregateOp::LAST: v = c.last; break;
+                }
+                g.values.push_back(v);
+            }
+            groups.push_back(std::move(g));
+        }
+    }
+
+    // 分组键顺序：逐个键比较，产品键比较字符串
+    auto keyLess = [&](const Group& a, const Group& b) {
+        for (size_t i = 0; i < keys.size(); ++i) {
+            if (keys[i] == GroupKey::PRODUCT) {
+                if (a.tuple->product != b.tuple->product) {
+                    return a.tuple->product < b.tuple->product;
+                }
+            } else if (a.tuple->parts[i] != b.tuple->parts[i]) {
+                return a.tuple->parts[i] < b.tuple->parts[i];
+            }
+        }
+        return false;
+    };
+    auto less = [&](const Group& a, const Group& b) {
+        if (orderColumn != SIZE_MAX && a.values[orderColumn] != b.values[orderColumn]) {
+            return descending ? a.values[orderColumn] > b.values[orderColumn]
+                              : a.values[orderColumn] < b.values[orderColumn];
+        }
+        return keyLess(a, b);
+    };
+    const size_t kept = std::min(rowLimit, groups.size());
+    std::partial_sort(groups.begin(), groups.begin() + kept, groups.end(), less);
+
+    for (size_t g = 0; g < kept; ++g) {
+        AggregateRow row;
+        for (size_t i = 0; i < keys.size(); ++i) {
+            row.keys.push_back(formatKey(keys[i], *groups[g].tuple, i));
+        }
+        row.values = std::move(groups[g].values);
+        table.rows.push_back(std::move(row));
+    }
+    return table;
+}
@@ -0,0 +1,279 @@
+/**
+ * @file SalesValidator.cpp
+ * @brief 销售数据校验与去重实现
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#include "SalesValidator.h"
+#include "ProductCatalog.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string_view>
+#include <thread>
+
+namespace {
+
+constexpr int64_t kInvalidDay = INT64_MIN;
+
+int64_t parseDay(const std::string& text) {
+    int64_t day = 0;
+    return parseCivilDate(text, day) ? day : kInvalidDay;
+}
+
+// 对一段连续的列做范围检查：无分支，编译器可以向量化
+void checkRanges(const int32_t* sales, const int32_t* stock, const double* price, size_t n,
+                 const ValidationConfig& config, uint8_t* flags) {
+    const int32_t maxSales = config.maxDailySales;
+    const int32_t maxStock = config.maxStock;
+    const double maxPrice = config.maxPrice;
+    for (size_t i = 0; i < n; ++i) {
+        const uint8_t badSales = (sales[i] < 0) | (sales[i] > maxSales);
+        const uint8_t badStock = (stock[i] < 0) | (stock[i] > maxStock);
+        // NaN 与任何值比较都为 false，!(p > 0) 同时拒绝 NaN
+        const uint8_t badPrice = !(price[i] > 0.0) | (price[i] > maxPrice);
+        flags[i] = static_cast<uint8_t>(badSales * SalesValidator::kBadSales |
+                                        badStock * SalesValidator::kBadStock |
+                                        badPrice * SalesValidator::kBadPrice);
+    }
+}
+
+/**
+ * @brief (产品, 天) 的开放寻址哈希集合
+ * 槽位保存产品 ID 哈希、天数与首次出现的行号；哈希与天数都相同时再比较产品 ID 字符串，
+ * 64 位哈希碰撞时按不同产品继续探测。
+ */
+class DayKeySet {
+public:
+    DayKeySet(const std::vector<Sale>& rows, size_t expected) : rows(rows) {
+        size_t capacity = 16;
+        while (capacity < expected * 2) {
+            capacity <<= 1;
+        }
+        slots.assign(capacity, Slot{});
+        mask = capacity - 1;
+    }
+
+    // 插入成功返回 true，已存在返回 false
+    bool insert(uint64_t productHash, int64_t day, size_t row) {
+        size_t i = mix(productHash, day) & mask;
+        for (;; i = (i + 1) & mask) {
+            Slot& slot = slots[i];
+            if (slot.row == kEmpty) {
+                slot = {productHash, day, row};
+                return true;
+            }
+            if (slot.productHash == productHash && slot.day == day &&
+                rows[slot.row].productId == rows[row].productId) {
+                return false;
+            }
+        }
+    }
+
+private:
+    static constexpr size_t kEmpty = SIZE_MAX;
+
+    struct Slot {
+        uint64_t productHash = 0;
+        int64_t day = 0;
+        size_t row = kEmpty;
+    };
+
+    static size_t mix(uint64_t productHash, int64_t day) {
+        uint64_t h = productHash ^ (static_cast<uint64_t>(day) * 0x9e3779b97f4a7c15ull);
+        h ^= h >> 29;
+        return static_cast<size_t>(h * 0xbf58476d1ce4e5b9ull);
+    }
+
+    const std::vector<Sale>& rows;
+    std::vector<Slot> slots;
+    size_t mask = 0;
+};
+
+void writeRejectRows(std::ostream& out, const std::vector<RejectedRow>& rows) {
+    for (const RejectedRow& r : rows) {
+        if (r.row != RejectedRow::kUnknownRow) {
+            out << r.row;
+        }
+        out << "," << SalesValidator::reasonText(r.reasons) << "," << r.sale.date << ","
+            << r.sale.productId << "," << r.sale.sales << "," << r.sale.price << ","
+            << r.sale.stock << "\n";
+    }
+}
+
+constexpr const char* kRejectsHeader = "row,reason,date,productId,sales,price,stock\n";
+
+}  // namespace
+
+SalesValidator::SalesValidator(const ValidationConfig& config) : config(config) {}
+
+ValidationReport SalesValidator::validate(std::vector<Sale>& rows, unsigned numThreads) {
+    ValidationReport report;
+    const size_t n = rows.size();
+    report.checked = n;
+    if (n == 0) {
+        return report;
+    }
+    if (numThreads == 0) {
+        numThreads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    numThreads = static_cast<unsigned>(std::min<size_t>(numThreads, (n + 4095) / 4096));
+    numThreads = std::max(1u, numThreads);
+    const unsigned partitions = numThreads;
+
+    std::vector<uint8_t> flags(n);
+    std::vector<int64_t> days(n);
+    std::vector<uint64_t> productHashes(n);
+    // byPartition[chunk][partition]：该块中属于该分区的行号（升序）
+    std::vector<std::vector<std::vector<size_t>>> byPartition(
+        numThreads, std::vector<std::vector<size_t>>(partitions));
+
+    // 1. 分块：取列、范围检查、解析日期、按产品分区
+    const size_t chunkSize = (n + numThreads - 1) / numThreads;
+    auto scanChunk = [&](unsigned chunk) {
+        const size_t begin = std::min(n, chunk * chunkSize);
+        const size_t end = std::min(n, begin + chunkSize);
+        constexpr size_t kBatch = 1024;
+        int32_t sales[kBatch];
+        int32_t stock[kBatch];
+        double price[kBatch];
+        std::hash<std::string_view> hasher;
+        for (size_t base = begin; base < end; base += kBatch) {
+            const size_t count = std::min(kBatch, end - base);
+            for (size_t i = 0; i < count; ++i) {
+                const Sale& s = rows[base + i];
+                sales[i] = s.sales;
+                stock[i] = s.stock;
+                price[i] = s.price;
+            }
+            checkRanges(sales, stock, price, count, config, flags.data() + base);
+            for (size_t i = 0; i < count; ++i) {
+                const size_t row = base + i;
+                days[row] = parseDay(rows[row].date);
+                if (days[row] == kInvalidDay) {
+                    flags[row] |= kBadDate;
+                }
+                if (flags[row] == 0) {
+                    productHashes[row] = hasher(rows[row].productId);
+                    byPartition[chunk][productHashes[row] % partitions].push_back(row);
+                }
+            }
+        }
+    };
+
+    // 2. 每个分区按行序（KEEP_LAST 时逆序）去重，同一产品只出现在一个分区
+    auto dedupPartition = [&](unsigned part) {
+        size_t expected = 0;
+        for (unsigned chunk = 0; chunk < numThreads; ++chunk) {
+            expected += byPartition[chunk][part].size();
+        }
+        DayKeySet seen(rows, expected);
+        auto visit = [&](size_t row) {
+            if (!seen.insert(productHashes[row], days[row], row)) {
+                flags[row] |= kDuplicate;
+            }
+        };
+        if (config.dedup == DedupPolicy::KEEP_FIRST) {
+            for (unsigned chunk = 0; chunk < numThreads; ++chunk) {
+                for (size_t row : byPartition[chunk][part]) {
+                    visit(row);
+                }
+            }
+        } else {
+            for (unsigned chunk = numThreads; chunk-- > 0;) {
+                const auto& list = byPartition[chunk][part];
+                for (auto it = list.rbegin(); it != list.rend(); ++it) {
+                    visit(*it);
+                }
+            }
+        }
+    };
+
+    auto runParallel = [&](auto&& task) {
+        std::vector<std::thread> workers;
+        for (unsigned t = 1; t < numThreads; ++t) {
+            workers.emplace_back(task, t);
+        }
+        task(0u);
+        for (auto& w : workers) {
+            w.join();
+        }
+    };
+    runParallel(scanChunk);
+    runParallel(dedupPartition);
+
+    // 3. 按原顺序压缩，拒绝行移入 rejected
+    size_t kept = 0;
+    for (size_t row = 0; row < n; ++row) {
+        const uint8_t f = flags[row];
+        if (f == 0) {
+            if (kept != row) {
+                rows[kept] = std::move(rows[row]);
+            }
+            kept++;
+            continue;
+        }
+        report.badSales += (f & kBadSales) != 0;
+        report.badStock += (f & kBadStock) != 0;
+        report.badPrice += (f & kBadPrice) != 0;
+        report.badDate += (f & kBadDate) != 0;
+        report.duplicates += (f & kDuplicate) != 0;
+        rejected.push_back({config.recordRowNumbers ? row : RejectedRow::kUnknownRow, f,
+                            std::move(rows[row])});
+    }
+    rows.resize(kept);
+    report.accepted = kept;
+    return report;
+}
+
+const std::vector<RejectedRow>& SalesValidator::rejects() const {
+    return rejected;
+}
+
+bool SalesValidator::writeRejects(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out.is_open()) {
+        std::cerr << "Error: Cannot create rejects file " << path << std::endl;
+        return false;
+    }
+    out << kRejectsHeader;
+    writeRejectRows(out, rejected);
+    return static_cast<bool>(out);
+}
+
+bool SalesValidator::flushRejects(const std::string& path) {
+    std::ofstream out(path, rejectsStarted ? std::ios::app : std::ios::trunc);
+    if (!out.is_open()) {
+        std::cerr << "Error: Cannot create rejects file " << path << std::endl;
+        return false;
+    }
+    if (!rejectsStarted) {
+        out << kRejectsHeader;
+        rejectsStarted = true;
+    }
+    writeRejectRows(out, rejected);
+    rejected.clear();
+    rejected.shrink_to_fit();
+    return static_cast<bool>(out);
+}
+
+std::string SalesValidator::reasonText(uint8_t reasons) {
+    static const std::pair<uint8_t, const char*> names[] = {
+        {kBadSales, "sales"}, {kBadStock, "stock"},         {kBadPrice, "price"},
+        {kBadDate, "date"},   {kDuplicate, "duplicate"},
+    };
+    std::string text;
+    for (const auto& [bit, name] : names) {
+        if (reasons & bit) {
+            if (!text.empty()) {
+                text += '|';
+            }
+            text += name;
+        }
+    }
+    return text;
+}
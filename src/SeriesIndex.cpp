@@ -0,0 +1,46 @@
+/**
+ * @file SeriesIndex.cpp
+ * @brief 产品系列谱系索引实现
+ * @author Zhao Runtian (124090988)
+ * @date 2025-11-18
+ */
+
+#include "SeriesIndex.h"
+#include <algorithm>
+
+void SeriesIndex::addProduct(uint32_t handle, const std::string& series, int64_t launchDay) {
+    if (newerDay.size() <= handle) {
+        newerDay.resize(handle + 1, kNever);
+    }
+    if (series.empty() || launchDay == INT64_MIN) {
+        return;
+    }
+
+    std::vector<Member>& list = seriesMembers[series];
+    auto pos = std::upper_bound(list.begin(), list.end(), launchDay,
+                                [](int64_t day, const Member& m) { return day < m.launchDay; });
+
+    // 自己的新款：上市日严格更晚的第一个成员（upper_bound 已跳过同日上市的）
+    newerDay[handle] = pos != list.end() ? pos->launchDay : kNever;
+
+    // 更早上市的成员：本品可能是它们更早出现的新款
+    for (auto it = list.begin(); it != pos; ++it) {
+        if (it->launchDay < launchDay) {
+            newerDay[it->handle] = std::min(newerDay[it->handle], launchDay);
+        }
+    }
+
+    list.insert(pos, Member{launchDay, handle});
+}
+
+std::vector<uint32_t> SeriesIndex::members(const std::string& series) const {
+    std::vector<uint32_t> handles;
+    auto it = seriesMembers.find(series);
+    if (it != seriesMembers.end()) {
+        handles.reserve(it->second.size());
+        for (const auto& member : it->second) {
+            handles.push_back(member.handle);
+        }
+    }
+    return handles;
+}
@@ -7,43 +7,131 @@
 
 #include "ThreadManager.h"
 #include "PricingStrategy.h"  // 需要定价策略模块
+#include "CoroutineSimulator.h"
+#include "PriceJournal.h"
+#include "PriceChangeFeed.h"
+#include "ElasticityEstimator.h"
 #include <random>
 #include <algorithm>
 #include <ctime>
 #include <cstdlib>
+#include <cstdio>
 
 // ============================================================================
 // ThreadSafePriceTable 实现
 // ============================================================================
 
+VersionedPrice ThreadSafePriceTable::readEntry(const PriceEntry& entry) {
+    // seqlock 读：版本号前后一致且不处于写入中才返回
+    while (true) {
+        const uint64_t before = entry.seq.load(std::memory_order_acquire);
+        if (before & 1) {
+            std::this_thread::yield();
+            continue;
+        }
+        const double price = entry.price.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (entry.seq.load(std::memory_order_relaxed) == before) {
+            return VersionedPrice{price, before / 2};
+        }
+    }
+}
+
+bool ThreadSafePriceTable::tryWriteEntry(const std::string& productId, PriceEntry& entry,
+                                         uint64_t expectedSeq, double newPrice) {
+    // CAS 抢占写入权：成功后版本号为奇数，其他写者的 CAS 会失败
+    if (!entry.seq.compare_exchange_strong(expectedSeq, expectedSeq + 1,
+                                           std::memory_order_acquire)) {
+        return false;
+    }
+    const double oldPrice = entry.price.load(std::memory_order_relaxed);
+    entry.price.store(newPrice, std::memory_order_relaxed);
+    entry.seq.store(expectedSeq + 2, std::memory_order_release);  // 先发布，读者不再等待后续记录
+
+    // 日志与变更流在写入窗口之外完成：同一产品按版本号依次接力，日志顺序仍与修改顺序一致
+    const uint64_t version = expectedSeq / 2 + 1;
+    while (entry.logged.load(std::memory_order_acquire) != version - 1) {
+        std::this_thread::yield();
+    }
+    if (journal) {
+        journal->append(productId, newPrice);
+    }
+    if (feed) {
+        if (entry.feedHandle == UINT32_MAX) {
+            entry.feedHandle = feed->intern(productId);
+        }
+        feed->publish(entry.feedHandle, oldPrice, newPrice, version);
+    }
+    entry.logged.store(version, std::memory_order_release);
+    return true;
+}
+
 double ThreadSafePriceTable::getPrice(const std::string& productId) const {
+    return getVersioned(productId).price;  // 产品不存在返回0
+}
+
+VersionedPrice ThreadSafePriceTable::getVersioned(const std::string& productId) const {
     std::shared_lock<std::shared_mutex> lock(rwMutex);  // 共享锁（读）
     auto it = prices.find(productId);
     if (it != prices.end()) {
-        return it->second;
+        return readEntry(it->second);
     }
-    return 0.0;  // 产品不存在返回0
+    return VersionedPrice{};
 }
 
 void ThreadSafePriceTable::setPrice(const std::string& productId, double price) {
-    std::unique_lock<std::shared_mutex> lock(rwMutex);  // 独占锁（写）
-    prices[productId] = price;
+    {
+        std::shared_lock<std::shared_mutex> lock(rwMutex);
+        auto it = prices.find(productId);
+        if (it != prices.end()) {
+            while (true) {
+                uint64_t seq = it->second.seq.load(std::memory_order_relaxed) & ~uint64_t(1);
+                if (tryWriteEntry(productId, it->second, seq, price)) {
+                    return;
+                }
+                std::this_thread::yield();  // 其他写者持有写入权，让出时间片再重试
+            }
+        }
+    }
+    
+    std::unique_lock<std::shared_mutex> lock(rwMutex);  // 新产品：独占锁（写）插入
+    PriceEntry& entry = prices.try_emplace(productId).first->second;
+    tryWriteEntry(productId, entry, entry.seq.load(std::memory_order_relaxed), price);
 }
 
-bool ThreadSafePriceTable::updatePriceIfLower(const std::string& productId, double newPrice) {
-    std::unique_lock<std::shared_mutex> lock(rwMutex);
+bool ThreadSafePriceTable::compareAndSet(const std::string& productId,
+                                         uint64_t expectedVersion, double newPrice) {
+    if (expectedVersion > 0) {
+        std::shared_lock<std::shared_mutex> lock(rwMutex);
+        auto it = prices.find(productId);
+        return it != prices.end() &&
+               tryWriteEntry(productId, it->second, expectedVersion * 2, newPrice);
+    }
     
-    auto it = prices.find(productId);
-    if (it == prices.end() || newPrice < it->second) {
-        prices[productId] = newPrice;
-        return true;
+    std::unique_lock<std::shared_mutex> lock(rwMutex);
+    auto [it, inserted] = prices.try_emplace(productId);
+    return inserted && tryWriteEntry(productId, it->second, 0, newPrice);
+}
+
+bool ThreadSafePriceTable::updatePriceIfLower(const std::string& productId, double newPrice) {
+    while (true) {
+        VersionedPrice current = getVersioned(productId);
+        if (current.version > 0 && newPrice >= current.price) {
+            return false;
+        }
+        if (compareAndSet(productId, current.version, newPrice)) {
+            return true;
+        }
     }
-    return false;
 }
 
 std::map<std::string, double> ThreadSafePriceTable::getAllPrices() const {
     std::shared_lock<std::shared_mutex> lock(rwMutex);
-    return prices;  // 返回副本
+    std::map<std::string, double> snapshot;
+    for (const auto& [productId, entry] : prices) {
+        snapshot.emplace_hint(snapshot.end(), productId, readEntry(entry).price);
+    }
+    return snapshot;  // 返回副本
 }
 
 size_t ThreadSafePriceTable::size() const {
@@ -51,6 +139,36 @@ size_t ThreadSafePriceTable::size() const {
     return prices.size();
 }
 
+void ThreadSafePriceTable::attachJournal(PriceJournal* j) {
+    std::unique_lock<std::shared_mutex> lock(rwMutex);
+    journal = j;
+}
+
+void ThreadSafePriceTable::attachFeed(PriceChangeFeed* f) {
+    std::unique_lock<std::shared_mutex> lock(rwMutex);
+    feed = f;
+    for (auto& [productId, entry] : prices) {
+        entry.feedHandle = f ? f->intern(productId) : UINT32_MAX;
+    }
+}
+
+void ThreadSafePriceTable::restore(std::map<std::string, double>&& recovered) {
+    std::map<std::string, PriceEntry> rebuilt;
+    for (const auto& [productId, price] : recovered) {
+        PriceEntry& entry = rebuilt.try_emplace(rebuilt.end(), productId)->second;
+        entry.price.store(price, std::memory_order_relaxed);
+        entry.seq.store(2, std::memory_order_relaxed);  // 恢复出的价格视为版本 1
+        entry.logged.store(1, std::memory_order_relaxed);
+        if (feed) {
+            entry.feedHandle = feed->intern(productId);
+        }
+    }
+    recovered.clear();
+    
+    std::unique_lock<std::shared_mutex> lock(rwMutex);
+    prices.swap(rebuilt);
+}
+
 // ============================================================================
 // ThreadSafeLogger 实现
 // ============================================================================
@@ -76,10 +194,10 @@ ThreadSafeLogger::~ThreadSafeLogger() {
     }
 }
 
-void ThreadSafeLogger::log(const std::string& message) {
+void ThreadSafeLogger::log(std::string_view message) {
     {
         std::lock_guard<std::mutex> lock(queueMutex);
-        logQueue.push(message);
+        logQueue.emplace(message);
     }
     cv.notify_one();  // 通知写入线程
 }
@@ -117,7 +235,7 @@ void ThreadSafeLogger::writerThreadFunc() {
 // ============================================================================
 
 ThreadManager::ThreadManager(const std::string& logFile)
-    : stopFlag(false), totalTasks(0), successTasks(0), failedTasks(0) {
+    : stopFlag(false), totalTasks(0), successTasks(0), failedTasks(0), consoleOutput(true) {
     
     logger = std::make_unique<ThreadSafeLogger>(logFile);
     logger->log("=== Pricing System Started ===");
@@ -126,6 +244,9 @@ ThreadManager::ThreadManager(const std::string& logFile)
 ThreadManager::~ThreadManager() {
     stopAll();
     waitAll();
+    if (changeFeed) {
+        priceTable.attachFeed(nullptr);
+    }
 }
 
 void ThreadManager::startPricing(const std::vector<Merchant>& merchants, 
@@ -151,6 +272,44 @@ void ThreadManager::startPricing(const std::vector<Merchant>& merchants,
     logger->log("All merchant threads started");
 }
 
+void ThreadManager::runCoroutinePricing(const std::vector<Merchant>& merchants,
+                                        pricing::PricingStrategy& strategy,
+                                        int numThreads) {
+#ifdef ENABLE_COROUTINE_SIM
+    numThreads = std::max(1, numThreads);
+    std::cout << "\n🚀 Starting coroutine pricing: " << merchants.size()
+              << " merchants on " << numThreads << " event loops...\n" << std::endl;
+    
+    stopFlag = false;
+    
+    // 商家按轮询方式分配到各事件循环
+    std::vector<std::unique_ptr<SimEventLoop>> loops;
+    for (int i = 0; i < numThreads; i++) {
+        loops.push_back(std::make_unique<SimEventLoop>());
+    }
+    for (size_t i = 0; i < merchants.size(); i++) {
+        SimEventLoop& loop = *loops[i % loops.size()];
+        loop.spawn(merchantPricingCoroutine(merchants[i], strategy, loop));
+    }
+    
+    std::vector<std::thread> loopThreads;
+    for (auto& loop : loops) {
+        loopThreads.emplace_back([&loop] { loop->run(); });
+    }
+    for (auto& thread : loopThreads) {
+        thread.join();
+    }
+    
+    logger->log("Coroutine pricing completed: " + std::to_string(merchants.size()) + " merchants");
+    std::cout << "\n✅ All merchant coroutines completed.\n" << std::endl;
+#else
+    (void)numThreads;
+    std::cerr << "Warning: built without ENABLE_COROUTINE_SIM, falling back to threads" << std::endl;
+    startPricing(merchants, strategy);
+    waitAll();
+#endif
+}
+
 void ThreadManager::merchantPricingThread(const Merchant& merchant, 
                                            pricing::PricingStrategy& strategy) {
     
@@ -193,31 +352,55 @@ void ThreadManager::merchantPricingThread(const Merchant& merchant,
     logger->log(threadLog);
 }
 
+#ifdef ENABLE_COROUTINE_SIM
+SimTask ThreadManager::merchantPricingCoroutine(const Merchant& merchant,
+                                                pricing::PricingStrategy& strategy,
+                                                SimEventLoop& loop) {
+    std::mt19937 gen(static_cast<unsigned>(std::hash<std::string>{}(merchant.name)));
+    std::uniform_int_distribution<> delayDist(50, 200);  // 50-200ms
+    
+    for (const auto& productId : merchant.products) {
+        if (stopFlag) {
+            break;
+        }
+        
+        PricingTask task = executePricingTask(merchant.name, productId, strategy);
+        recordPriceChange(task, merchant.name);
+        
+        totalTasks++;
+        if (task.success) {
+            successTasks++;
+        } else {
+            failedTasks++;
+        }
+        
+        // 模拟网络延迟：挂起协程而不是阻塞线程
+        co_await loop.sleepFor(std::chrono::milliseconds(delayDist(gen)));
+    }
+}
+#endif
+
 PricingTask ThreadManager::executePricingTask(const std::string& merchantName,
                                                const std::string& productId,
                                                pricing::PricingStrategy& strategy) {
+    // 本次任务的临时字符串都从线程的周期内存池分配，返回时整体释放
+    pricing::ArenaScope arenaScope(pricing::CycleArena::forThisThread());
+    
     PricingTask task;
     task.merchantName = merchantName;
     task.productId = productId;
     task.timestamp = std::chrono::system_clock::now();
     
     try {
-        // 1. 获取当前价格（如果存在）
-        double currentPrice = priceTable.getPrice(productId);
-        
-        // 2. 如果是首次定价，生成基础价格
-        if (currentPrice == 0.0) {
-            std::random_device rd;
-            std::mt19937 gen(rd());
-            std::uniform_real_distribution<> priceDist(5000.0, 15000.0);
-            currentPrice = priceDist(gen);
-        }
+        // 1. 随机数生成器
+        std::random_device rd;
+        std::mt19937 gen(rd());
         
-        task.basePrice = currentPrice;
+        // 2. 首次定价时使用的基础价格
+        std::uniform_real_distribution<> priceDist(5000.0, 15000.0);
+        const double initialPrice = priceDist(gen);
         
         // 3. 创建产品和市场上下文（实际项目中应从数据模块获取）
-        std::random_device rd;
-        std::mt19937 gen(rd());
         std::uniform_int_distribution<> stockDist(50, 500);
         std::uniform_int_distribution<> viewDist(100, 2000);
         std::uniform_int_distribution<> cartDist(20, 400);
@@ -225,27 +408,20 @@ PricingTask ThreadManager::executePricingTask(const std::string& merchantName,
         std::uniform_real_distribution<> demandDist(50.0, 250.0);
         std::uniform_real_distribution<> competitorPriceDist(0.85, 1.15);
         
-        // 确定产品类别
-        std::string category = "other";
-        if (productId.find("iPhone") != std::string::npos) {
-            category = "smartphone";
-        } else if (productId.find("MacBook") != std::string::npos) {
-            category = "laptop";
-        } else if (productId.find("RTX") != std::string::npos) {
-            category = "gpu";
-        }
+        // 产品元数据来自目录（按句柄取，不再逐任务做子串匹配）
+        const uint32_t handle = catalog.resolve(productId);
+        const ProductInfo& meta = catalog.info(handle);
         
         pricing::Product product;
         product.id = productId;
-        product.name = productId;
-        product.category = category;
-        product.basePrice = currentPrice;
+        product.name = meta.name;
+        product.category = categoryKey(meta.category);
         product.stock = stockDist(gen);
-        product.isNewModel = (productId.find("New") != std::string::npos);
-        product.series = category;
+        product.isNewModel = meta.isNewModel;
+        product.series = meta.series;
         
+        const double competitorRatio = competitorPriceDist(gen);
         pricing::MarketContext context;
-        context.competitorPrice = currentPrice * competitorPriceDist(gen);
         context.demandForecast = demandDist(gen);
         context.isPeakSeason = (std::rand() % 10 < 3);  // 30% 概率是旺季
         context.viewCount = viewDist(gen);
@@ -253,28 +429,42 @@ PricingTask ThreadManager::executePricingTask(const std::string& merchantName,
         context.purchaseCount = purchaseDist(gen);
         std::time_t now = std::time(nullptr);
         context.currentTime = *std::localtime(&now);
-        context.newerModelInSeriesAvailable = (std::rand() % 10 < 2);  // 20% 概率有新款
+        context.newerModelInSeriesAvailable = catalog.hasNewerInSeries(handle, now / 86400);
+        if (elasticity) {
+            context.priceElasticity = elasticity->estimate(handle).elasticity;
+        }
         
-        // 4. 调用定价策略计算新价格
-        pricing::PricingResult result = strategy.calculatePrice(product, context);
-        double newPrice = result.newPrice;
+        // 4-5. 基于最新价格计算并乐观提交；其他商家抢先改价时以新价格重算，不丢失更新
+        double currentPrice = 0.0;
+        const VersionedPrice committed = priceTable.update(productId, [&](double latest) {
+            currentPrice = (latest == 0.0) ? initialPrice : latest;
+            product.basePrice = currentPrice;
+            context.competitorPrice = currentPrice * competitorRatio;
+            return strategy.calculatePrice(product, context).newPrice;
+        });
+        double newPrice = committed.price;
+        task.basePrice = currentPrice;
         task.adjustedPrice = newPrice;
         task.stockLevel = product.stock;
-        
-        // 5. 更新价格表
-        priceTable.setPrice(productId, newPrice);
         task.success = true;
         
         // 6. 输出日志
-        std::stringstream ss;
-        ss << std::fixed << std::setprecision(2);
-        ss << "[" << merchantName << "] " << productId 
-           << ": ¥" << currentPrice << " → ¥" << newPrice
-           << " (" << std::showpos << ((newPrice / currentPrice - 1) * 100) 
-           << std::noshowpos << "%)";
+        char numbers[96];
+        const int numbersLength = std::snprintf(
+            numbers, sizeof(numbers), ": ¥%.2f → ¥%.2f (%+.2f%%)",
+            currentPrice, newPrice, (newPrice / currentPrice - 1) * 100);
+        pricing::ArenaString message(pricing::currentResource());
+        message.reserve(merchantName.size() + productId.size() + sizeof(numbers));
+        message += "[";
+        message += merchantName;
+        message += "] ";
+        message += productId;
+        message.append(numbers, numbersLength > 0 ? static_cast<size_t>(numbersLength) : 0);
         
-        std::cout << ss.str() << std::endl;
-        logger->log(ss.str());
+        if (consoleOutput) {
+            std::cout << message << std::endl;
+        }
+        logger->log(message);
         
     } catch (const std::exception& e) {
         task.success = false;
@@ -293,8 +483,14 @@ void ThreadManager::recordPriceChange(const PricingTask& task,
                                        const std::string& merchantName) {
     std::lock_guard<std::mutex> lock(historyMutex);
     
-    PriceRecord record;
-    record.timestamp = getCurrentTimeString();
+    // 未达上限时原地构造，字段直接写入历史内存池；已满时覆盖最旧的记录
+    const bool full = historyLimit != 0 && priceHistory.size() >= historyLimit;
+    PriceRecord& record = full ? priceHistory[historyNext] : priceHistory.emplace_back();
+    if (full) {
+        historyNext = (historyNext + 1) % historyLimit;
+    }
+    char timeText[32];
+    record.timestamp.assign(timeText, formatCurrentTime(timeText, sizeof(timeText)));
     record.merchantName = merchantName;
     record.productId = task.productId;
     record.originalPrice = task.basePrice;
@@ -303,7 +499,18 @@ void ThreadManager::recordPriceChange(const PricingTask& task,
     record.stockLevel = task.stockLevel;
     record.status = task.success ? "SUCCESS" : "FAILED";
     
-    priceHistory.push_back(record);
+    if (task.success) {
+        const int64_t seconds = std::chrono::duration_cast<std::chrono::seconds>(
+            task.timestamp.time_since_epoch()).count();
+        // 各商家的调价是独立的价格流，分开成序列
+        priceSeries.append(merchantName + "|" + task.productId, seconds, task.adjustedPrice);
+        repriceLeaders.add(task.productId);
+    }
+}
+
+std::vector<HeavyHitter> ThreadManager::getMostRepriced(size_t count) const {
+    std::lock_guard<std::mutex> lock(historyMutex);
+    return repriceLeaders.top(count);
 }
 
 void ThreadManager::waitAll() {
@@ -318,10 +525,25 @@ void ThreadManager::waitAll() {
 }
 
 void ThreadManager::stopAll() {
+    if (scheduler) {
+        scheduler->stop();  // 先停止投递，再唤醒工作线程
+    }
     stopFlag = true;
     queueCV.notify_all();  // 唤醒所有等待的线程
 }
 
+void ThreadManager::setHistoryLimit(size_t limit) {
+    std::lock_guard<std::mutex> lock(historyMutex);
+    // 先还原为时间顺序（最旧的在前），再丢弃超出新上限的最旧记录
+    std::rotate(priceHistory.begin(), priceHistory.begin() + historyNext, priceHistory.end());
+    if (limit != 0 && priceHistory.size() > limit) {
+        priceHistory.erase(priceHistory.begin(),
+                           priceHistory.begin() + (priceHistory.size() - limit));
+    }
+    historyLimit = limit;
+    historyNext = 0;
+}
+
 void ThreadManager::exportPriceTrend(const std::string& filename) const {
     std::ofstream file(filename);
     
@@ -336,7 +558,8 @@ void ThreadManager::exportPriceTrend(const std::string& filename) const {
     
     // 写入数据
     std::lock_guard<std::mutex> lock(const_cast<std::mutex&>(historyMutex));
-    for (const auto& record : priceHistory) {
+    for (size_t i = 0; i < priceHistory.size(); ++i) {
+        const PriceRecord& record = priceHistory[(historyNext + i) % priceHistory.size()];
         file << std::fixed << std::setprecision(2);
         file << record.timestamp << ","
              << record.merchantName << ","
@@ -365,7 +588,26 @@ void ThreadManager::printStatistics() const {
               << " (" << (totalTasks > 0 ? failedTasks * 100.0 / totalTasks : 0) 
               << "%)" << std::endl;
     std::cout << "Unique products: " << priceTable.size() << std::endl;
-    
+    std::cout << "Series points:   " << priceSeries.pointCount()
+              << " (" << priceSeries.memoryBytes() / 1024 << " KB)" << std::endl;
+
+    const std::vector<HeavyHitter> mostRepriced = getMostRepriced(5);
+    if (!mostRepriced.empty()) {
+        std::cout << "Most repriced:  ";
+        for (const HeavyHitter& h : mostRepriced) {
+            std::cout << " " << h.key << " (" << h.count << ")";
+        }
+        std::cout << std::endl;
+    }
+
+    if (scheduler) {
+        SchedulerStats stats = scheduler->getStats();
+        std::cout << "Timers:          " << stats.activeTimers
+                  << " (dispatched " << stats.dispatched
+                  << ", coalesced " << stats.coalesced
+                  << ", missed " << stats.missedDeadlines << ")" << std::endl;
+    }
+
     std::cout << std::string(60, '=') << std::endl;
     
     // 显示价格范围
@@ -383,13 +625,10 @@ void ThreadManager::printStatistics() const {
     std::cout << std::string(60, '=') << "\n" << std::endl;
 }
 
-std::string ThreadManager::getCurrentTimeString() const {
+size_t ThreadManager::formatCurrentTime(char* buffer, size_t size) const {
     auto now = std::chrono::system_clock::now();
     auto time_t = std::chrono::system_clock::to_time_t(now);
-    
-    std::stringstream ss;
-    ss << std::put_time(std::localtime(&time_t), "%Y-%m-%d %H:%M:%S");
-    return ss.str();
+    return std::strftime(buffer, size, "%Y-%m-%d %H:%M:%S", std::localtime(&time_t));
 }
 
 void ThreadManager::simulateDelay(int minMs, int maxMs) {
@@ -459,4 +698,65 @@ void ThreadManager::startWorkers(int numWorkers, pricing::PricingStrategy& strat
             logger->log("[" + workerName + "] Stopped");
         });
     }
+}
+
+// ============================================================================
+// 价格日志
+// ============================================================================
+
+size_t ThreadManager::enableJournal(const std::string& directory) {
+    return enableJournal(directory, JournalConfig());
+}
+
+size_t ThreadManager::enableJournal(const std::string& directory, const JournalConfig& config) {
+    journal.reset();  // 先关闭旧日志（析构时解除挂接）
+    journal = std::make_unique<PriceJournal>(directory, priceTable, config);
+    
+    logger->log("Price journal enabled: " + directory + ", recovered "
+                + std::to_string(priceTable.size()) + " prices");
+    return priceTable.size();
+}
+
+PriceChangeFeed& ThreadManager::enableChangeFeed(size_t capacity) {
+    if (!changeFeed) {
+        changeFeed = std::make_unique<PriceChangeFeed>(capacity);
+        priceTable.attachFeed(changeFeed.get());
+    }
+    return *changeFeed;
+}
+
+// ============================================================================
+// 定时重定价模式实现
+// ============================================================================
+
+void ThreadManager::startScheduledPricing(
+        const std::vector<Merchant>& merchants,
+        const std::function<std::chrono::milliseconds(const std::string&)>& cadenceOf) {
+    
+    if (!scheduler) {
+        // 定时器键为 "商家|产品"，到期时拆分后投递到任务队列
+        scheduler = std::make_unique<RepricingScheduler>([this](const std::string& key) {
+            size_t sep = key.rfind('|');
+            PricingTask task;
+            task.merchantName = key.substr(0, sep);
+            task.productId = key.substr(sep + 1);
+            addTask(task);
+        });
+    }
+    
+    size_t timerCount = 0;
+    for (const auto& merchant : merchants) {
+        for (const auto& productId : merchant.products) {
+            scheduler->schedule(merchant.name + "|" + productId, cadenceOf(productId));
+            timerCount++;
+        }
+    }
+    
+    scheduler->start();
+    logger->log("Scheduled pricing started: " + std::to_string(timerCount) + " timers");
+    std::cout << "⏰ Scheduled pricing started with " << timerCount << " timers" << std::endl;
+}
+
+SchedulerStats ThreadManager::getSchedulerStats() const {
+    return scheduler ? scheduler->getStats() : SchedulerStats{};
 }
\ No newline at end of file
@@ -12,7 +12,8 @@
 
 using namespace std;
 
-void Visualizer::generateDashboard(const string& csvPath, const string& htmlPath) {
+void Visualizer::generateDashboard(const string& csvPath, const string& htmlPath,
+                                   const ProductCatalog* catalog) {
     cout << "📊 Generating Dashboard Interface..." << endl;
 
     auto data = parseCSV(csvPath);
@@ -21,7 +22,7 @@ void Visualizer::generateDashboard(const string& csvPath, const string& htmlPath
         return;
     }
 
-    string htmlContent = buildHtml(data);
+    string htmlContent = buildHtml(data, catalog);
 
     ofstream htmlFile(htmlPath);
     if (!htmlFile.is_open()) {
@@ -91,7 +92,8 @@ string Visualizer::vecToString(const vector<ChartData>& data, const string& fiel
     return ss.str();
 }
 
-string Visualizer::generateSidebarHtml(const map<string, vector<ChartData>>& data) {
+string Visualizer::generateSidebarHtml(const map<string, vector<ChartData>>& data,
+                                       const ProductCatalog* catalog) {
     stringstream ss;
     bool isFirst = true;
     for (const auto& [pid, history] : data) {
@@ -106,7 +108,19 @@ string Visualizer::generateSidebarHtml(const map<string, vector<ChartData>>& dat
 
         ss << "<div class=\"product-item" << activeClass << "\" onclick=\"switchProduct('" << pid << "')\" id=\"btn-" << pid << "\">";
 
-        string iconClass = (pid.find("P1") != string::npos) ? "fa-mobile-alt" : "fa-laptop";
+        // 图标按目录类别选择
+        const uint32_t handle = catalog ? catalog->find(pid) : ProductCatalog::kInvalidHandle;
+        const ProductCategory category = handle != ProductCatalog::kInvalidHandle
+                                             ? catalog->info(handle).category
+                                             : ProductCatalog::inferFromId(pid).category;
+        string iconClass;
+        switch (category) {
+            case ProductCategory::SMARTPHONE: iconClass = "fa-mobile-alt"; break;
+            case ProductCategory::LAPTOP: iconClass = "fa-laptop"; break;
+            case ProductCategory::GPU: iconClass = "fa-microchip"; break;
+            case ProductCategory::TABLET: iconClass = "fa-tablet-alt"; break;
+            case ProductCategory::GENERAL: iconClass = "fa-box-open"; break;
+        }
 
         ss << "  <div class=\"prod-icon\"><i class=\"fas " << iconClass << "\"></i></div>";
         ss << "  <div class=\"prod-info\">";
@@ -121,7 +135,8 @@ string Visualizer::generateSidebarHtml(const map<string, vector<ChartData>>& dat
     return ss.str();
 }
 
-string Visualizer::buildHtml(const map<string, vector<ChartData>>& data) {
+string Visualizer::buildHtml(const map<string, vector<ChartData>>& data,
+                             const ProductCatalog* catalog) {
     if (data.empty()) return "<html><body>No Data</body></html>";
 
     string defaultPid = data.begin()->first;
@@ -249,7 +264,7 @@ string Visualizer::buildHtml(const map<string, vector<ChartData>>& data) {
     ss << "<div class=\"sidebar\">\n";
     ss << "  <div class=\"brand\"><i class=\"fas fa-microchip\"></i> C++ Pricing Core</div>\n";
     ss << "  <div class=\"section-label\">INVENTORY MONITOR</div>\n";
-    ss << generateSidebarHtml(data);
+    ss << generateSidebarHtml(data, catalog);
     ss << "</div>\n";
 
     ss << "<div class=\"main-content\">\n";
@@ -4,9 +4,19 @@
  */
 
 #include "DataLoader.h"
+#include "DailyHistory.h"
+#include "SalesAnomalyFilter.h"
+#include "SalesValidator.h"
+#include "SalesQuery.h"
 #include "Forecaster.h"
 #include "InventoryAlert.h"
 #include "PricingStrategy.h"
+#include "ProductCatalog.h"
+#include "ElasticityEstimator.h"
+#include "ForecastHierarchy.h"
+#include "PriceOptimizer.h"
+#include "ClearancePlanner.h"
+#include "SalesPartitioner.h"
 #include "../include/Visualizer.h"
 #include <iostream>
 #include <vector>
@@ -14,100 +24,384 @@
 #include <string>
 #include <fstream>
 #include <iomanip>
+#include <cstdlib>
+#include <filesystem>
+#include <queue>
+#include <utility>
 
 using namespace std;
 using namespace pricing;
 
-// 简单的辅助结构，用于在内存中整理历史数据
-struct ProductHistory {
-    vector<string> dates;
-    vector<double> prices;
-    vector<int> stocks;
-    vector<double> sales; // 修复：类型改为 double，匹配 Forecaster 接口
-    double lastPrice;
-    int lastStock;
+static const int kDaysToEndOfLife = 60;
+static const int kForecastHorizon = 14;
+static const int kLeadTimeDays = 7;
+static const size_t kBestSellers = 5;
+static const char* kRejectsPath = "output/rejects.csv";
+static const size_t kRejectFlushRows = 4096;  // 外存模式累计这么多拒绝行就追加写出一次
+static const char* kWeeklyRevenuePath = "output/weekly_revenue.csv";
+
+// 预警与定价的共享组件（内存模式与外存模式共用）
+struct PricingPipeline {
+    PricingPipeline(ProductCatalog& catalog, ElasticityEstimator& elasticity)
+        : catalog(catalog), elasticity(elasticity) {}
+
+    ProductCatalog& catalog;
+    ElasticityEstimator& elasticity;
+    PricingStrategy strategy;
+    PriceOptimizer optimizer{PriceObjective::REVENUE};
+    InventoryAlert alert;
 };
 
-int main() {
-    cout << "=== Intelligent Pricing System Initiated ===" << endl;
+// 旧款清仓问题：有新款上市的产品在停售前按 DP 规划逐日折扣（非旧款返回 false）
+static bool buildClearanceProblem(ProductCatalog& catalog, const ElasticityEstimator& elasticity,
+                                  const string& pid, const DailySeries& h,
+                                  ClearanceProblem& problem) {
+    const uint32_t handle = catalog.resolve(pid);
+    if (catalog.info(handle).isNewModel || !catalog.hasNewerInSeries(handle, h.lastDay())) {
+        return false;
+    }
+    problem.basePrice = h.price(h.lastDay());
+    problem.stock = h.stock(h.lastDay());
+    problem.dailyDemand.assign(kDaysToEndOfLife, Forecaster::predictNext(h.dailySales(), 3));
+    problem.elasticity = elasticity.estimate(handle).elasticity;
+    return true;
+}
 
-    // 1. 数据加载
-    DataLoader loader("sales_history.txt");
-    if (!loader.loadData()) {
-        loader = DataLoader("../sales_history.txt");
-        if (!loader.loadData()) {
-            cerr << "❌ Error: Cannot open sales_history.txt" << endl;
-            return 1;
+// 层级汇总：类别级提前期需求（按类别制定采购计划）
+static void printCategoryDemand(const ForecastHierarchy& hierarchy) {
+    cout << "Category demand over " << kLeadTimeDays << "-day lead time:" << endl;
+    for (ProductCategory c : {ProductCategory::SMARTPHONE, ProductCategory::LAPTOP,
+                              ProductCategory::GPU, ProductCategory::TABLET,
+                              ProductCategory::GENERAL}) {
+        const NodeForecast node = hierarchy.category(c);
+        if (node.skuCount == 0) {
+            continue;
         }
+        const HorizonForecast hf = node.expand(kForecastHorizon, kLeadTimeDays);
+        cout << "  " << categoryKey(c) << " (" << node.skuCount << " SKUs): " << fixed
+             << setprecision(1) << hf.leadTimeDemand << " [" << hf.leadTimeLower << ", "
+             << hf.leadTimeUpper << "]" << defaultfloat << endl;
+    }
+}
+
+// 一个产品的预警、定价与 CSV 输出
+static void priceProduct(PricingPipeline& pipeline, const string& pid, const DailySeries& h,
+                         const HorizonForecast& forecast, const ClearancePlan* plan,
+                         ostream& csvFile) {
+    const double lastPrice = h.price(h.lastDay());
+    const int lastStock = h.stock(h.lastDay());
+
+    // A. 预测
+    double nextDemand = forecast.mean.front();
+
+    const uint32_t handle = pipeline.catalog.resolve(pid);
+    const ProductInfo& meta = pipeline.catalog.info(handle);
+
+    // B. 预警：库存对比提前期内的累计需求
+    pipeline.alert.checkAlert(pid, meta.name, forecast, lastStock, meta.category);
+
+    // C. 定价
+    Product p;
+    p.id = pid;
+    p.name = meta.name;
+    p.category = categoryKey(meta.category);
+    p.series = meta.series;
+    p.isNewModel = meta.isNewModel;
+    p.basePrice = lastPrice;
+    p.stock = lastStock;
+
+    MarketContext ctx;
+    ctx.demandForecast = nextDemand;
+    ctx.competitorPrice = lastPrice * 0.98;
+    ctx.priceElasticity = pipeline.elasticity.estimate(handle).elasticity;
+    ctx.newerModelInSeriesAvailable = pipeline.catalog.hasNewerInSeries(handle, h.lastDay());
+    if (plan) {
+        ctx.plannedMarkdown = plan->today();
     }
-    const vector<Sale>& allSales = loader.getSalesData();
+
+    PricingResult res = pipeline.strategy.calculatePrice(p, ctx);
+
+    cout << "Product " << pid << ": New Price -> " << res.newPrice << endl;
+
+    // 对照：按实测弹性求收益最优价（同样的区间与竞品约束）；
+    // 库存与补货提前期内的累计需求比较，而不是单日需求
+    PriceProblem problem;
+    problem.basePrice = lastPrice;
+    problem.referenceDemand = forecast.leadTimeDemand;
+    problem.elasticity = ctx.priceElasticity;
+    problem.stock = lastStock;
+    problem.competitorPrice = ctx.competitorPrice;
+    cout << "  Revenue-optimal -> " << pipeline.optimizer.solve(problem).price << endl;
+
+    // D. 写入 CSV（逐日输出，缺失天销量为 0）
+    for (int64_t day = h.firstDay(); day <= h.lastDay(); ++day) {
+        double finalP = (day == h.lastDay()) ? res.newPrice : h.price(day);
+        double demand = (day == h.lastDay()) ? nextDemand : 0.0;
+
+        csvFile << DailyHistory::formatDay(day) << "," << pid << ","
+                << h.price(day) << "," << finalP << ","
+                << h.stock(day) << ",GREEN,"
+                << h.sales(day) << "," << demand << endl;
+    }
+}
+
+// 校验结果汇总，拒绝行写入旁路文件
+static void reportValidation(SalesValidator& validator, const ValidationReport& total) {
+    validator.flushRejects(kRejectsPath);
+    if (total.accepted == total.checked) {
+        return;
+    }
+    cout << "⚠️  Rejected " << total.checked - total.accepted << " of " << total.checked
+         << " records (" << total.duplicates << " duplicate, " << total.badSales
+         << " bad sales, " << total.badStock << " bad stock, " << total.badPrice
+         << " bad price, " << total.badDate << " bad date) -> " << kRejectsPath << endl;
+}
+
+// 销售报表：收入前 5 的 SKU 及其售罄率，按类别 × 周的收入写入 CSV
+static void printSalesReport(const vector<Sale>& sales, const ProductCatalog& catalog) {
+    const AggregateTable top = SalesQuery(sales, &catalog)
+                                   .groupBy(GroupKey::PRODUCT)
+                                   .sum(Measure::REVENUE)
+                                   .sum(Measure::UNITS)
+                                   .last(Measure::STOCK)
+                                   .orderBy(0)
+                                   .limit(5)
+                                   .run();
+    cout << "Top " << top.rows.size() << " SKUs by revenue:" << endl;
+    for (const AggregateRow& row : top.rows) {
+        // 售罄率 = 期内销量 / (期内销量 + 期末库存)
+        const double units = row.values[1];
+        const double sellThrough = units + row.values[2] > 0 ? units / (units + row.values[2]) : 0.0;
+        cout << "  " << row.keys[0] << ": revenue " << fixed << setprecision(1) << row.values[0]
+             << ", sell-through " << sellThrough * 100.0 << "%" << defaultfloat << endl;
+    }
+
+    SalesQuery(sales, &catalog)
+        .groupBy(GroupKey::CATEGORY)
+        .groupBy(GroupKey::WEEK)
+        .sum(Measure::REVENUE)
+        .sum(Measure::UNITS)
+        .run()
+        .writeCsv(kWeeklyRevenuePath);
+}
+
+// 内存模式：全部销售记录载入内存，批量预测与规划
+static bool runInMemory(const string& salesPath, ProductCatalog& catalog, ostream& csvFile) {
+    DataLoader loader(salesPath);
+    if (!loader.loadData()) {
+        return false;
+    }
+    vector<Sale> allSales = loader.releaseSalesData();
     cout << "✅ Loaded " << allSales.size() << " records." << endl;
 
+    // 重复的 (日期, 产品) 与越界值在分组前剔除，否则会重复计入销量
+    SalesValidator validator;
+    reportValidation(validator, validator.validate(allSales));
+
+    // 按产品滚动中位数 / MAD 截断异常销量，避免录入错误推高预测与价格
+    SalesAnomalyFilter anomalyFilter;
+    for (size_t i = 0; i < allSales.size(); ++i) {
+        anomalyFilter.observe(allSales[i], i);
+    }
+    for (const auto& a : anomalyFilter.anomalies()) {
+        cout << "⚠️  Anomalous sales " << a.productId << " " << a.date << ": " << a.original
+             << " -> " << a.replacement << endl;
+    }
+
     // 2. 整理数据 (按产品分组)
-    map<string, ProductHistory> histories;
-    for (const auto& s : allSales) {
-        histories[s.productId].dates.push_back(s.date);
-        histories[s.productId].prices.push_back(s.price);
-        histories[s.productId].stocks.push_back(s.stock);
-        // 修复：显式转换为 double
-        histories[s.productId].sales.push_back(static_cast<double>(s.sales));
-        histories[s.productId].lastPrice = s.price;
-        histories[s.productId].lastStock = s.stock;
+    // 按日历天对齐：缺失的天补 0 销量，移动平均窗口不会因缺行错位
+    DailyHistory dailyHistory;
+    dailyHistory.build(allSales);
+    const auto& histories = dailyHistory.products();
+
+    // 价格弹性：按 SKU 拟合并向类别收缩
+    ElasticityEstimator elasticity(catalog);
+    elasticity.ingest(allSales);
+
+    // 旧款清仓计划（并行规划）
+    vector<string> legacyIds;
+    vector<ClearanceProblem> clearanceProblems;
+    for (const auto& [pid, h] : histories) {
+        ClearanceProblem problem;
+        if (buildClearanceProblem(catalog, elasticity, pid, h, problem)) {
+            legacyIds.push_back(pid);
+            clearanceProblems.push_back(std::move(problem));
+        }
+    }
+    map<string, ClearancePlan> clearancePlans;
+    vector<ClearancePlan> plans = ClearancePlanner().planBatch(clearanceProblems);
+    for (size_t i = 0; i < plans.size(); ++i) {
+        clearancePlans[legacyIds[i]] = std::move(plans[i]);
     }
 
-    // 3. 运行核心逻辑
-    PricingStrategy strategy;
-    InventoryAlert alert;
+    // 之后日序列以压缩列常驻，定价时逐个产品解压
+    dailyHistory.compress();
 
-    system("mkdir -p output");
-    string csvPath = "output/price_trend_detailed.csv";
-    ofstream csvFile(csvPath);
+    // 多步需求预测：每个产品按块解码一次遍历，补货提前期内的累计需求供预警使用
+    vector<HorizonForecast> forecasts;
+    forecasts.reserve(histories.size());
+    for (const auto& [pid, h] : histories) {
+        forecasts.push_back(
+            Forecaster::forecastHorizon(h.columns(), kForecastHorizon, kLeadTimeDays, 3));
+    }
 
-    if (csvFile.is_open()) {
-        csvFile << "date,productId,basePrice,finalPrice,stock,alertLevel,sales,predictedDemand" << endl;
+    ForecastHierarchy hierarchy(catalog, 3);
+    hierarchy.ingest(dailyHistory);
+    printCategoryDemand(hierarchy);
 
-        for (auto& [pid, h] : histories) {
-            // A. 预测
-            vector<double> forecast = Forecaster::movingAverage(h.sales, 3);
-            double nextDemand = forecast.empty() ? 0.0 : Forecaster::predictNext(h.sales, 3);
+    // 3. 运行核心逻辑
+    PricingPipeline pipeline(catalog, elasticity);
+    size_t productIndex = 0;
+    for (const auto& [pid, h] : histories) {
+        auto plan = clearancePlans.find(pid);
+        priceProduct(pipeline, pid, h.expand(), forecasts[productIndex++],
+                     plan != clearancePlans.end() ? &plan->second : nullptr, csvFile);
+    }
+    printSalesReport(allSales, catalog);
+    return true;
+}
+
+// 外存模式：按产品分区落盘，逐个产品组流式预测、预警与定价，内存受预算约束
+static bool runExternal(const string& salesPath, size_t memoryBudgetMB, ProductCatalog& catalog,
+                        ostream& csvFile) {
+    PartitionConfig config;
+    config.memoryBudgetBytes = memoryBudgetMB << 20;
+    SalesPartitioner partitioner(config);
+    if (!partitioner.partition(salesPath)) {
+        return false;
+    }
+    cout << "✅ Partitioned " << salesPath << " into " << partitioner.partitionCount()
+         << " partition(s) for a " << memoryBudgetMB << " MB budget." << endl;
 
-            // B. 预警 (修复：添加 productName 参数)
-            alert.checkAlert(pid, "Product " + pid, nextDemand, h.lastStock);
+    // 逐组更新的状态只按 SKU 数增长：弹性的类别估计随处理进度逐步完善
+    ElasticityEstimator elasticity(catalog);
+    ForecastHierarchy hierarchy(catalog, 3);
+    ClearancePlanner planner;
+    PricingPipeline pipeline(catalog, elasticity);
+    ValidationConfig validationConfig;
+    validationConfig.recordRowNumbers = false;  // 分组后的行序不是原文件行序
+    SalesValidator validator(validationConfig);
+    ValidationReport validation;
+    // 每个产品的总销量只在它的分组里出现一次，保留最大的 kBestSellers 个即为精确的前几名
+    using UnitsEntry = pair<uint64_t, string>;
+    auto ranksAbove = [](const UnitsEntry& a, const UnitsEntry& b) {
+        return a.first != b.first ? a.first > b.first : a.second < b.second;
+    };
+    priority_queue<UnitsEntry, vector<UnitsEntry>, decltype(ranksAbove)> bestSellers(ranksAbove);
+    size_t anomalies = 0;
 
-            // C. 定价
-            Product p;
-            p.id = pid;
-            p.basePrice = h.lastPrice;
-            p.stock = h.lastStock;
+    size_t products = partitioner.forEachProduct([&](const string& pid, vector<Sale>& rows) {
+        // 同一产品的全部行都在这一组里，组内去重即全局去重
+        const ValidationReport r = validator.validate(rows, 1);
+        validation.checked += r.checked;
+        validation.accepted += r.accepted;
+        validation.badSales += r.badSales;
+        validation.badStock += r.badStock;
+        validation.badPrice += r.badPrice;
+        validation.badDate += r.badDate;
+        validation.duplicates += r.duplicates;
+        if (validator.rejects().size() >= kRejectFlushRows) {
+            validator.flushRejects(kRejectsPath);  // 拒绝行不随输入规模常驻内存
+        }
 
-            MarketContext ctx;
-            ctx.demandForecast = nextDemand;
-            ctx.competitorPrice = h.lastPrice * 0.98;
+        SalesAnomalyFilter anomalyFilter;
+        for (size_t i = 0; i < rows.size(); ++i) {
+            anomalies += anomalyFilter.observe(rows[i], i);
+        }
+        DailyHistory dailyHistory;
+        dailyHistory.build(rows);
+        const DailySeries* h = dailyHistory.find(pid);
+        if (!h) {
+            return;
+        }
+        elasticity.ingest(rows, 1);
+        hierarchy.ingest(dailyHistory, 1);
+        uint64_t units = 0;
+        for (const Sale& sale : rows) {
+            units += static_cast<uint64_t>(sale.sales);
+        }
+        bestSellers.emplace(units, pid);
+        if (bestSellers.size() > kBestSellers) {
+            bestSellers.pop();  // 堆顶是排名最低的一个
+        }
 
-            PricingResult res = strategy.calculatePrice(p, ctx);
+        const HorizonForecast forecast =
+            Forecaster::forecastHorizon(h->dailySales(), kForecastHorizon, kLeadTimeDays, 3);
+        ClearanceProblem problem;
+        ClearancePlan plan;
+        const bool legacy = buildClearanceProblem(catalog, elasticity, pid, *h, problem);
+        if (legacy) {
+            plan = planner.plan(problem);
+        }
+        priceProduct(pipeline, pid, *h, forecast, legacy ? &plan : nullptr, csvFile);
+    });
 
-            cout << "Product " << pid << ": New Price -> " << res.newPrice << endl;
+    cout << "✅ Streamed " << products << " products";
+    if (anomalies > 0) {
+        cout << " (" << anomalies << " anomalous sales values winsorised)";
+    }
+    cout << "." << endl;
+    reportValidation(validator, validation);
+    printCategoryDemand(hierarchy);
+    vector<UnitsEntry> ranking;
+    for (; !bestSellers.empty(); bestSellers.pop()) {
+        ranking.push_back(bestSellers.top());
+    }
+    cout << "Best sellers:" << endl;
+    for (auto it = ranking.rbegin(); it != ranking.rend(); ++it) {
+        cout << "  " << it->second << ": " << it->first << " units" << endl;
+    }
+    return true;
+}
 
-            // D. 写入 CSV
-            for (size_t i = 0; i < h.dates.size(); ++i) {
-                double finalP = (i == h.dates.size() - 1) ? res.newPrice : h.prices[i];
-                double demand = (i == h.dates.size() - 1) ? nextDemand : 0.0;
+// 用法：main [--external <内存预算 MB>] [销售文件]
+int main(int argc, char* argv[]) {
+    cout << "=== Intelligent Pricing System Initiated ===" << endl;
 
-                csvFile << h.dates[i] << "," << pid << ","
-                        << h.prices[i] << "," << finalP << ","
-                        << h.stocks[i] << ",GREEN,"
-                        << h.sales[i] << "," << demand << endl;
-            }
+    size_t memoryBudgetMB = 0;  // 0 表示内存模式
+    string salesPath = "sales_history.txt";
+    for (int i = 1; i < argc; ++i) {
+        const string arg = argv[i];
+        if (arg == "--external" && i + 1 < argc) {
+            memoryBudgetMB = std::max(1, atoi(argv[++i]));
+        } else {
+            salesPath = arg;
         }
-        csvFile.close();
-        cout << "✅ Logic complete. Data exported to CSV." << endl;
-    } else {
+    }
+    if (!std::filesystem::exists(salesPath) && std::filesystem::exists("../" + salesPath)) {
+        salesPath = "../" + salesPath;
+    }
+
+    // 产品目录：类别/系列/新款标记（缺失时按产品 ID 推断）
+    ProductCatalog catalog;
+    if (catalog.loadFromFile("product_catalog.txt") == 0) {
+        catalog.loadFromFile("../product_catalog.txt");
+    }
+
+    system("mkdir -p output");
+    string csvPath = "output/price_trend_detailed.csv";
+    ofstream csvFile(csvPath);
+    if (!csvFile.is_open()) {
         cerr << "❌ Error: Cannot create output CSV." << endl;
         return 1;
     }
+    csvFile << "date,productId,basePrice,finalPrice,stock,alertLevel,sales,predictedDemand" << endl;
 
-    // 4. 可视化
-    Visualizer::generateDashboard(csvPath, "output/dashboard.html");
+    // 1. 数据加载与处理
+    const bool ok = memoryBudgetMB > 0
+                        ? runExternal(salesPath, memoryBudgetMB, catalog, csvFile)
+                        : runInMemory(salesPath, catalog, csvFile);
+    if (!ok) {
+        cerr << "❌ Error: Cannot open " << salesPath << endl;
+        return 1;
+    }
+    csvFile.close();
+    cout << "✅ Logic complete. Data exported to CSV." << endl;
+
+    // 4. 可视化（外存模式的数据量不适合单页仪表盘）
+    if (memoryBudgetMB == 0) {
+        Visualizer::generateDashboard(csvPath, "output/dashboard.html", &catalog);
+    }
 
     return 0;
-}
\ No newline at end of file
+}
@@ -7,13 +7,283 @@
 
 #include "ThreadManager.h"
 #include "PricingStrategy.h"
+#include "MarketSimulator.h"
+#include "DeterministicSimulator.h"
+#include "PriceChangeFeed.h"
+#include "PriceOptimizer.h"
+#include "ClearancePlanner.h"
+#include "DataLoader.h"
+#include "SimSupport.h"
 #include <iostream>
 #include <vector>
 #include <string>
+#include <sstream>
+#include <cstdlib>
+#include <cmath>
 
 using namespace pricing;
 
-int main() {
+/**
+ * @brief 协程压测模式：thread_demo --coroutine <商家数> [事件循环线程数]
+ */
+static int runCoroutineLoadTest(int merchantCount, int numThreads) {
+    system("mkdir -p output");
+    ThreadManager manager("output/pricing.log");
+    manager.setConsoleOutput(false);
+    PricingStrategy strategy;
+    
+    const std::vector<std::string> catalog = {
+        "iPhone-15-Pro", "iPhone-15-Pro-Max", "MacBook-Pro-14",
+        "MacBook-Pro-16", "RTX-4080", "RTX-4090"
+    };
+    std::vector<Merchant> merchants;
+    merchants.reserve(merchantCount);
+    for (int i = 0; i < merchantCount; i++) {
+        merchants.emplace_back("Merchant-" + std::to_string(i),
+                               std::vector<std::string>{catalog[i % catalog.size()],
+                                                        catalog[(i + 1) % catalog.size()]},
+                               3);
+    }
+    
+    auto start = std::chrono::steady_clock::now();
+    manager.runCoroutinePricing(merchants, strategy, numThreads);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    
+    manager.printStatistics();
+    std::cout << "⏱  " << merchantCount << " merchants in " << elapsed.count() << " ms" << std::endl;
+    return 0;
+}
+
+/**
+ * @brief 加载产品目录（工作目录可能是构建目录）
+ */
+static void loadDemoCatalog(ProductCatalog& catalog) {
+    if (catalog.loadFromFile("product_catalog.txt") == 0) {
+        catalog.loadFromFile("../product_catalog.txt");
+    }
+}
+
+/**
+ * @brief 竞争市场模式：thread_demo --market <商家数> [tick 数]
+ */
+static int runMarketSimulation(int merchantCount, int ticks) {
+    system("mkdir -p output");
+    PricingStrategy strategy;
+    
+    const std::vector<std::string> catalog = {
+        "iPhone-15-Pro", "iPhone-15-Pro-Max", "MacBook-Pro-14",
+        "MacBook-Pro-16", "RTX-4080", "RTX-4090"
+    };
+    std::vector<Merchant> merchants;
+    for (int i = 0; i < merchantCount; i++) {
+        std::vector<std::string> products;
+        for (size_t k = 0; k < catalog.size(); k++) {
+            if ((i + k) % 2 == 0) {
+                products.push_back(catalog[k]);
+            }
+        }
+        merchants.emplace_back("Merchant-" + std::to_string(i), products, 3);
+    }
+    
+    ProductCatalog productCatalog;
+    loadDemoCatalog(productCatalog);
+    MarketSimulator market(merchants, strategy, productCatalog);
+    auto start = std::chrono::steady_clock::now();
+    market.run(ticks);
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start);
+    
+    std::cout << "\n📉 Best prices after " << ticks << " ticks (" << elapsed.count() << " ms):" << std::endl;
+    for (const auto& [product, price] : market.getBestPrices()) {
+        std::cout << "  " << product << ": ¥" << std::fixed << std::setprecision(2) << price << std::endl;
+    }
+    market.exportBestPriceTrend("output/market_best_price.csv");
+    return 0;
+}
+
+/**
+ * @brief 全目录求解模式：thread_demo --optimize <SKU 数> [线程数]
+ */
+static int runOptimizerBenchmark(size_t skuCount, unsigned numThreads) {
+    uint64_t rng = 2025;
+    std::vector<PriceProblem> problems(skuCount);
+    for (auto& problem : problems) {
+        problem.basePrice = sim::uniform(rng, 500.0, 15000.0);
+        problem.referenceDemand = sim::uniform(rng, 5.0, 300.0);
+        problem.elasticity = sim::uniform(rng, -3.5, -0.3);
+        problem.stock = static_cast<int>(sim::uniform(rng, 0.0, 500.0));
+        problem.unitCost = problem.basePrice * sim::uniform(rng, 0.5, 0.8);
+        problem.competitorPrice = problem.basePrice * sim::uniform(rng, 0.85, 1.15);
+    }
+    
+    for (PriceObjective objective : {PriceObjective::REVENUE, PriceObjective::MARGIN}) {
+        PriceOptimizer optimizer(objective);
+        auto start = std::chrono::steady_clock::now();
+        std::vector<PriceSolution> solutions = optimizer.solveBatch(problems, numThreads);
+        auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start);
+        
+        double total = 0.0;
+        for (const auto& solution : solutions) {
+            total += solution.objective;
+        }
+        std::cout << (objective == PriceObjective::REVENUE ? "Revenue" : "Margin")
+                  << "-optimal prices for " << skuCount << " SKUs in " << elapsed.count()
+                  << " ms, total objective ¥" << std::fixed << std::setprecision(0) << total
+                  << std::endl;
+    }
+    return 0;
+}
+
+/**
+ * @brief 清仓规划自检：thread_demo --clearance
+ * 对恒定日需求的问题，按计划折扣逐日重算期望销量，应与计划给出的售出件数一致；
+ * 全程不降价时即为总需求（库存不足时为库存）。
+ */
+static int runClearanceCheck() {
+    const int days = 60;
+    ClearancePlanner planner;
+    int failures = 0;
+    for (double elasticity : {-1.2, -3.0}) {
+        for (int stock : {50, 5000}) {
+            for (double rate : {0.4, 0.6, 5.0, 200.0}) {
+                ClearanceProblem problem;
+                problem.basePrice = 100.0;
+                problem.stock = stock;
+                problem.dailyDemand.assign(days, rate);
+                problem.elasticity = elasticity;
+                const ClearancePlan plan = planner.plan(problem);
+
+                double remaining = stock;
+                double sold = 0.0;
+                bool markedDown = false;
+                for (double markdown : plan.markdown) {
+                    const double q = std::min(remaining, rate * std::pow(1.0 - markdown, elasticity));
+                    sold += q;
+                    remaining -= q;
+                    markedDown |= markdown > 0.0;
+                }
+                const double expected = markedDown ? sold : std::min<double>(stock, rate * days);
+                const double tolerance = 1e-6 * stock;
+                const bool ok = std::fabs(plan.expectedSold - sold) <= tolerance &&
+                                std::fabs(plan.expectedSold - expected) <= tolerance &&
+                                std::fabs(plan.expectedSold + plan.expectedLeftover - stock) <= tolerance;
+                failures += !ok;
+                std::cout << std::fixed << std::setprecision(2) << (ok ? "  ok   " : "  FAIL ")
+                          << "e=" << elasticity << " stock=" << stock << " demand=" << rate
+                          << "/day: sold " << plan.expectedSold << " (expected " << expected << "), leftover "
+                          << plan.expectedLeftover << ", first markdown " << plan.today() * 100
+                          << "%" << std::defaultfloat << std::endl;
+            }
+        }
+    }
+    return failures == 0 ? 0 : 1;
+}
+
+/**
+ * @brief 子集导入模式：thread_demo --load <销售文件> <产品ID,...|all> [起始日期] [截止日期]
+ * 索引缺失或与数据文件不一致时先重建。
+ */
+static int runSubsetLoad(int argc, char* argv[]) {
+    const std::string path = argc > 2 ? argv[2] : "sales_history.txt";
+    LoadFilter filter;
+    if (argc > 3 && std::string(argv[3]) != "all") {
+        std::stringstream ids(argv[3]);
+        std::string id;
+        while (std::getline(ids, id, ',')) {
+            filter.products.insert(id);
+        }
+    }
+    filter.fromDate = argc > 4 ? argv[4] : "";
+    filter.toDate = argc > 5 ? argv[5] : "";
+
+    if (!DataLoader::indexIsCurrent(path) && !DataLoader::buildIndex(path)) {
+        return 1;
+    }
+    DataLoader loader(path);
+    auto start = std::chrono::steady_clock::now();
+    if (!loader.loadData(filter)) {
+        return 1;
+    }
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+    std::cout << "Loaded " << loader.getSalesData().size() << " rows in "
+              << elapsed.count() / 1000.0 << " ms" << std::endl;
+    return 0;
+}
+
+/**
+ * @brief 确定性模式：thread_demo --deterministic <seed> [tick 数] [线程数]
+ *        回放模式：thread_demo --replay <事件日志> [截止 tick]
+ */
+static int runDeterministic(const std::vector<Merchant>& merchants, int argc, char* argv[]) {
+    system("mkdir -p output");
+    const std::string logPath = "output/pricing_events.bin";
+    ThreadSafePriceTable table;
+    
+    if (std::string(argv[1]) == "--replay") {
+        const std::string path = argc > 2 ? argv[2] : logPath;
+        uint32_t maxTick = argc > 3 ? static_cast<uint32_t>(std::atoi(argv[3])) : UINT32_MAX;
+        if (!DeterministicSimulator::replay(path, table, maxTick)) {
+            return 1;
+        }
+    } else {
+        PricingStrategy strategy;
+        DeterministicConfig config;
+        config.seed = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 42;
+        config.ticks = argc > 3 ? std::atoi(argv[3]) : 24;
+        config.numThreads = argc > 4 ? std::atoi(argv[4]) : 0;
+        ProductCatalog catalog;
+        loadDemoCatalog(catalog);
+        DeterministicSimulator simulator(merchants, strategy, catalog, config);
+        simulator.run(table, logPath);
+        std::cout << "  事件日志: " << logPath << std::endl;
+    }
+    
+    for (const auto& [product, price] : table.getAllPrices()) {
+        std::cout << "  " << product << ": ¥" << std::fixed << std::setprecision(2) << price << std::endl;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc > 1 && std::string(argv[1]) == "--market") {
+        int merchantCount = argc > 2 ? std::atoi(argv[2]) : 1000;
+        int ticks = argc > 3 ? std::atoi(argv[3]) : 48;
+        return runMarketSimulation(merchantCount, ticks);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--optimize") {
+        size_t skuCount = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 500000;
+        unsigned numThreads = argc > 3 ? static_cast<unsigned>(std::atoi(argv[3])) : 0;
+        return runOptimizerBenchmark(skuCount, numThreads);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--clearance") {
+        return runClearanceCheck();
+    }
+    if (argc > 1 && std::string(argv[1]) == "--load") {
+        return runSubsetLoad(argc, argv);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--coroutine") {
+        int merchantCount = argc > 2 ? std::atoi(argv[2]) : 100000;
+        int numThreads = argc > 3 ? std::atoi(argv[3]) : 4;
+        return runCoroutineLoadTest(merchantCount, numThreads);
+    }
+    
+    // 定义商家和产品
+    std::vector<Merchant> merchants = {
+        Merchant("Apple官方店", {"iPhone-15-Pro", "iPhone-15-Pro-Max", "MacBook-Pro-14"}, 1),
+        Merchant("京东自营", {"iPhone-15-Pro", "MacBook-Pro-14", "RTX-4090"}, 2),
+        Merchant("天猫旗舰", {"iPhone-15-Pro-Max", "RTX-4090", "MacBook-Pro-16"}, 2),
+        Merchant("苏宁易购", {"MacBook-Pro-14", "MacBook-Pro-16", "RTX-4080"}, 3),
+        Merchant("拼多多", {"iPhone-15-Pro", "RTX-4080", "RTX-4090"}, 4)
+    };
+    
+    if (argc > 1 && (std::string(argv[1]) == "--deterministic" ||
+                     std::string(argv[1]) == "--replay")) {
+        return runDeterministic(merchants, argc, argv);
+    }
+    
     std::cout << "═══════════════════════════════════════════════════════" << std::endl;
     std::cout << "  多线程定价系统演示程序" << std::endl;
     std::cout << "  ThreadManager Demo" << std::endl;
@@ -26,18 +296,17 @@ int main() {
     // 创建 ThreadManager 实例
     ThreadManager manager("output/pricing.log");
     
+    // 启用价格日志：上次运行的价格从快照 + WAL 恢复，不再从随机基础价重新开始
+    manager.enableJournal("output/journal");
+    
+    // 加载产品目录（工作目录可能是构建目录）
+    if (manager.loadCatalog("product_catalog.txt") == 0) {
+        manager.loadCatalog("../product_catalog.txt");
+    }
+    
     // 创建定价策略
     PricingStrategy strategy;
     
-    // 定义商家和产品
-    std::vector<Merchant> merchants = {
-        Merchant("Apple官方店", {"iPhone-15-Pro", "iPhone-15-Pro-Max", "MacBook-Pro-14"}, 1),
-        Merchant("京东自营", {"iPhone-15-Pro", "MacBook-Pro-14", "RTX-4090"}, 2),
-        Merchant("天猫旗舰", {"iPhone-15-Pro-Max", "RTX-4090", "MacBook-Pro-16"}, 2),
-        Merchant("苏宁易购", {"MacBook-Pro-14", "MacBook-Pro-16", "RTX-4080"}, 3),
-        Merchant("拼多多", {"iPhone-15-Pro", "RTX-4080", "RTX-4090"}, 4)
-    };
-    
     std::cout << "📋 商家和产品列表：" << std::endl;
     for (const auto& merchant : merchants) {
         std::cout << "  • " << merchant.name << " (优先级: " << merchant.priority << ")" << std::endl;
@@ -47,6 +316,9 @@ int main() {
     }
     std::cout << std::endl;
     
+    // 订阅价格变更（只关注显卡），定价结束后增量读取
+    auto gpuFeed = manager.enableChangeFeed().subscribe({"RTX-4080", "RTX-4090"});
+    
     // 启动多线程定价
     manager.startPricing(merchants, strategy);
     
@@ -57,6 +329,16 @@ int main() {
     // 打印统计信息
     manager.printStatistics();
     
+    std::vector<PriceChangeEvent> gpuChanges;
+    gpuFeed->poll(gpuChanges);
+    std::cout << "📡 GPU 价格变更事件: " << gpuChanges.size() << std::endl;
+    for (const auto& event : gpuChanges) {
+        std::cout << "  #" << event.sequence << " "
+                  << manager.getChangeFeed()->productName(event.product) << " v" << event.version
+                  << ": ¥" << std::fixed << std::setprecision(2) << event.oldPrice
+                  << " → ¥" << event.newPrice << std::endl;
+    }
+    
     // 导出价格趋势
     manager.exportPriceTrend("output/price_trend.csv");
     